@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "atmsp/event_bus.h"
+#include "atmsp/printer_sp.h"
+#include "atmsp/receipt_template.h"
+#include "atmsp/time_source.h"
+#include "bench_util.h"
+
+// Receipt render cost (per-print JSON + parse vs compiled template) and the
+// latency a transaction thread sees for render + enqueue into the spool,
+// including when the slow device has filled it.
+
+namespace atmsp {
+std::unique_ptr<IPrinterSP> make_mock_printer(PrinterOptions opts);
+}
+
+using namespace atmsp;
+
+namespace {
+
+constexpr std::string_view kReceipt =
+    "        ATM SP DEMO BANK\n"
+    "{{terminal:<20}}{{date:>20}}\n"
+    "----------------------------------------\n"
+    "SESSION  {{session}}\n"
+    "CARD     {{pan}}\n"
+    "TXN      {{type:<12}}     AMOUNT {{amount:>8}}\n"
+    "RESULT   {{result}}\n"
+    "----------------------------------------\n"
+    "      THANK YOU - KEEP THIS RECEIPT\n";
+
+const std::vector<std::string_view> kValues = {
+    "ATM-DEMO-01", "2026-10-18 09:30:00", "S-1760779800", "541333******2345",
+    "WITHDRAWAL", "100.00", "APPROVED",
+};
+
+nlohmann::json json_fields() {
+    return { {"terminal", kValues[0]}, {"date", kValues[1]}, {"session", kValues[2]},
+             {"pan", kValues[3]}, {"type", kValues[4]}, {"amount", kValues[5]}, {"result", kValues[6]} };
+}
+
+void print_latency(const char* label, std::vector<std::int64_t>& ns) {
+    std::sort(ns.begin(), ns.end());
+    auto pct = [&](double p) { return ns[std::min(ns.size() - 1, static_cast<std::size_t>(p * ns.size()))]; };
+    std::printf("  %-34s p50=%6lld p99=%6lld p99.9=%7lld max=%8lld ns\n", label,
+                static_cast<long long>(pct(0.50)), static_cast<long long>(pct(0.99)),
+                static_cast<long long>(pct(0.999)), static_cast<long long>(ns.back()));
+}
+
+} // namespace
+
+int main() {
+    const auto compiled = *ReceiptTemplate::compile(kReceipt);
+    std::string out;
+
+    std::printf("render (one receipt):\n");
+    bench::run("json fields + parse template + render", 100'000, [&]{
+        out.clear();
+        auto t = ReceiptTemplate::compile(kReceipt);
+        t->render_json(json_fields(), out);
+        bench::do_not_optimize(out);
+    });
+    bench::run("json fields + compiled render", 100'000, [&]{
+        out.clear();
+        compiled.render_json(json_fields(), out);
+        bench::do_not_optimize(out);
+    });
+    bench::run("compiled render (field views)", 1'000'000, [&]{
+        out.clear();
+        compiled.render(kValues, out);
+        bench::do_not_optimize(out);
+    });
+
+    EventBus bus;
+    std::printf("render + enqueue via IPrinterSP::print():\n");
+    {
+        // Spool large enough to never fill: pure caller-side latency.
+        constexpr int kN = 20'000;
+        PrinterOptions o;
+        o.spoolCapacity = kN;
+        auto p = make_mock_printer(o);
+        p->init(&bus);
+        p->open("PRINTER1");
+        p->load_template("r", kReceipt);
+        auto t = p->find_template("r");
+        std::vector<std::int64_t> lat;
+        lat.reserve(kN);
+        for (int i = 0; i < kN; ++i) {
+            const auto t0 = TimeSource::now_ns();
+            const auto tk = p->print(*t, kValues);
+            lat.push_back(TimeSource::now_ns() - t0);
+            bench::do_not_optimize(tk);
+        }
+        print_latency("accepted (spool not full)", lat);
+        p->close();
+    }
+    {
+        // Default spool and a slow device under a burst far above its rate.
+        constexpr int kN = 5'000;
+        auto p = make_mock_printer(PrinterOptions{});
+        p->init(&bus);
+        p->open("PRINTER1");
+        p->load_template("r", kReceipt);
+        auto t = p->find_template("r");
+        std::vector<std::int64_t> lat;
+        lat.reserve(kN);
+        int busy = 0;
+        for (int i = 0; i < kN; ++i) {
+            const auto t0 = TimeSource::now_ns();
+            const auto tk = p->print(*t, kValues);
+            lat.push_back(TimeSource::now_ns() - t0);
+            busy += tk.result == SpError::Busy;
+        }
+        print_latency("burst into full spool (Busy)", lat);
+        const auto s = p->stats();
+        std::printf("  burst of %d: accepted=%llu busy=%d peakQueued=%zu\n", kN,
+                    static_cast<unsigned long long>(s.submitted), busy, s.peakQueued);
+        p->close();
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "atmsp/command_queue.h"
+#include "atmsp/event_bus.h"
+#include "atmsp/session.h"
+#include "atmsp/session_arena.h"
+#include "bench_util.h"
+
+// Simulates full card + PIN transactions and compares heap allocations and
+// throughput with and without the per-session arena.
+
+namespace {
+std::atomic<std::uint64_t> g_allocs{0};
+}
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace atmsp;
+
+namespace {
+
+// Answers every command immediately, like a mock SP with no device latency.
+class InstantSP final : public IServiceProvider {
+public:
+    std::string name() const override { return "InstantSP"; }
+    SpError init(EventBus*) override { return SpError::Ok; }
+    SpError open(const std::string&) override { return SpError::Ok; }
+    void close() override {}
+    std::future<nlohmann::json> execute(const std::string&, const nlohmann::json&) override {
+        std::promise<nlohmann::json> p;
+        p.set_value(nlohmann::json{{"ok", true}, {"masked", "****"}});
+        return p.get_future();
+    }
+};
+
+struct Result { double txPerSec; double allocsPerTx; };
+
+Result run_transactions(int count, ArenaPool* pool) {
+    EventBus bus;
+    std::uint64_t seen = 0;
+    // Two subscribers, as in the demo (logger + journal).
+    bus.subscribe([&](const Event&){ ++seen; });
+    bus.subscribe([&](const Event& e){ seen += e.index(); });
+
+    InstantSP sp;
+    CommandQueue pinQ(sp);
+    const nlohmann::json pinCmd = { {"minLen", 4}, {"maxLen", 6}, {"bypass", false} };
+    auto& src = bus.source("CARDREADER1");
+
+    const auto a0 = g_allocs.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        Session s("S-" + std::to_string(i), bus, pool);
+        s.start();
+        bus.publish(src, CardInserted{});
+        Track2Read t2;
+        t2.pan = "5413330089012345";
+        t2.exp = "2512";
+        bus.publish(src, t2);
+        bus.publish(src, PinRequested{ .minLen = 4, .maxLen = 6 });
+        auto reply = pinQ.submit("RequestPin", pinCmd, pool ? s.resource() : nullptr).get();
+        bench::do_not_optimize(reply);
+        bus.publish(src, PinEntered{ .masked = "****" });
+        bus.publish(src, CardRemoved{});
+        s.end(0);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto allocs = g_allocs.load() - a0;
+    bench::do_not_optimize(seen);
+
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    return { count / secs, static_cast<double>(allocs) / count };
+}
+
+} // namespace
+
+int main() {
+    constexpr int kTx = 50'000;
+    ArenaPool pool;
+    (void)run_transactions(1000, &pool);      // warm the pool and allocator
+    (void)run_transactions(1000, nullptr);
+
+    const auto heap  = run_transactions(kTx, nullptr);
+    const auto arena = run_transactions(kTx, &pool);
+
+    std::printf("card+PIN transactions: %d\n", kTx);
+    std::printf("  %-28s %10.0f tx/s %8.1f heap allocs/tx\n", "default heap", heap.txPerSec, heap.allocsPerTx);
+    std::printf("  %-28s %10.0f tx/s %8.1f heap allocs/tx\n", "session arena (pooled)", arena.txPerSec, arena.allocsPerTx);
+    const auto ps = pool.stats();
+    std::printf("  arena pool: owned=%zu idle=%zu draining=%zu\n", ps.owned, ps.idle, ps.draining);
+    return 0;
+}
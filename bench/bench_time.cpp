@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+#include "atmsp/events.h"
+#include "atmsp/time_source.h"
+#include "bench_util.h"
+
+// Compares the TimeSource / cached formatter path against the previous
+// system_clock + localtime + strftime path used for event stamps and logs.
+
+using namespace atmsp;
+
+namespace {
+
+// What BaseEvent used to carry.
+struct LegacyEvent { std::chrono::system_clock::time_point ts { std::chrono::system_clock::now() }; };
+
+std::string legacy_tp_to_string(const std::chrono::system_clock::time_point& tp) {
+    auto tt = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%F %T", &tm);
+    return buf;
+}
+
+} // namespace
+
+int main() {
+    constexpr std::int64_t kIters = 5'000'000;
+    (void)TimeSource::now();   // calibrate outside the timed loops
+    std::printf("TimeSource backend: %.*s\n", static_cast<int>(TimeSource::backend().size()),
+                TimeSource::backend().data());
+
+    std::printf("clock reads\n");
+    bench::run("system_clock::now()", kIters, []{ bench::do_not_optimize(std::chrono::system_clock::now()); });
+    bench::run("steady_clock::now()", kIters, []{ bench::do_not_optimize(std::chrono::steady_clock::now()); });
+    bench::run("TimeSource::now()", kIters, []{ bench::do_not_optimize(TimeSource::now()); });
+
+    std::printf("event construction\n");
+    bench::run("legacy event (system_clock stamp)", kIters, []{ LegacyEvent e; bench::do_not_optimize(e); });
+    bench::run("CardInserted (TimeSource stamp)", kIters, []{ CardInserted e; bench::do_not_optimize(e); });
+
+    std::printf("stamp + format (as logged per event)\n");
+    bench::run("system_clock + localtime + strftime", kIters / 5, []{
+        LegacyEvent e;
+        auto s = legacy_tp_to_string(e.ts);
+        bench::do_not_optimize(s);
+    });
+    bench::run("TimeSource + format_time (cached second)", kIters / 5, []{
+        CardInserted e;
+        auto t = format_time(e.ts);
+        bench::do_not_optimize(t);
+    });
+    bench::run("TimeSource + format_time millis", kIters / 5, []{
+        CardInserted e;
+        auto t = format_time(e.ts, true);
+        bench::do_not_optimize(t);
+    });
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <utility>
+
+// Minimal benchmark helpers shared by the bench/ executables (no external deps).
+
+namespace atmsp::bench {
+
+template <class T>
+inline void do_not_optimize(T const& v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &v;
+#endif
+}
+
+// Runs fn() iters times and prints ns/op. Returns ns/op.
+template <class Fn>
+double run(const char* label, std::int64_t iters, Fn&& fn) {
+    for (std::int64_t i = 0; i < iters / 10 + 1; ++i) fn();   // warm-up
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::int64_t i = 0; i < iters; ++i) fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iters);
+    std::printf("  %-44s %10.1f ns/op\n", label, ns);
+    return ns;
+}
+
+} // namespace atmsp::bench
@@ -0,0 +1,117 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "rate_limiter.h"
+#include "sp_interface.h"
+
+namespace atmsp {
+
+struct DeviceCommand {
+    std::string command;
+    nlohmann::json payload;
+};
+
+struct CommandQueueOptions {
+    // Commands handed to the SP before the oldest one must complete.
+    std::size_t maxInFlight{4};
+    // Idempotent setters: while still queued, a later call replaces the
+    // payload of an earlier one instead of reaching the SP twice.
+    std::unordered_set<std::string> coalesce{"SetFailureRate"};
+    // Per-device submission rate and cap on accepted-but-unfinished commands.
+    AdmissionLimits admission{};
+};
+
+struct CommandQueueStats {
+    std::uint64_t submitted{0};   // commands accepted (one per completion)
+    std::uint64_t dispatched{0};  // execute() calls made on the SP
+    std::uint64_t coalesced{0};   // commands folded into an earlier setter
+    std::uint64_t rejected{0};    // refused by admission control
+    std::size_t   peakInFlight{0};
+};
+
+// Per-logical-device command queue in front of an IServiceProvider.
+//
+// Commands are dispatched in submission order by a dispatch thread, keeping
+// up to maxInFlight execute() futures outstanding, and completed strictly in
+// the same order by a separate completion thread, so a slow command at the
+// head never holds back dispatch of later ones while slots are free.
+// Every submitted command gets its own future; coalesced setters complete
+// with the reply of the call that carried the final payload.
+// Commands refused by admission control complete immediately with
+// {"ok":false,"error":"RateLimited"|"TooManyInFlight"} and never reach the SP.
+class CommandQueue {
+public:
+    explicit CommandQueue(IServiceProvider& sp, CommandQueueOptions opts = {});
+    ~CommandQueue();   // completes everything already queued, then stops
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // If mr is given (e.g. Session::resource()), the completion's shared state
+    // and the queue's bookkeeping for the command are allocated from it.
+    std::future<nlohmann::json> submit(std::string command,
+                                       nlohmann::json payload = nlohmann::json::object(),
+                                       std::pmr::memory_resource* mr = nullptr);
+
+    // Queues all commands atomically (nothing else interleaves) and returns
+    // one future per element, in the same order. Admission covers the batch
+    // as a whole: if it does not fit, every element is rejected with the same
+    // error and none reaches the SP.
+    std::vector<std::future<nlohmann::json>> executeBatch(std::vector<DeviceCommand> cmds,
+                                                          std::pmr::memory_resource* mr = nullptr);
+
+    // Blocks until everything queued so far has completed.
+    void drain();
+
+    CommandQueueStats stats() const;
+    AdmissionStats admission_stats() const { return admission_.stats(); }
+    IServiceProvider& sp() { return sp_; }
+
+private:
+    // One queued command, allocated from the submitter's memory resource and
+    // freed by the completer.
+    struct Item {
+        explicit Item(std::pmr::memory_resource* r) : mr(r), waiters(r) {}
+        std::pmr::memory_resource* mr;
+        DeviceCommand cmd;
+        std::pmr::vector<std::promise<nlohmann::json>> waiters;
+        std::future<nlohmann::json> reply;   // set when dispatched
+        bool coalescible{false};
+    };
+
+    static Item* new_item(std::pmr::memory_resource* mr);
+    static void delete_item(Item* item);
+    std::future<nlohmann::json> enqueue_locked(DeviceCommand cmd, std::pmr::memory_resource* mr);
+    static std::promise<nlohmann::json> make_promise(std::pmr::memory_resource* mr);
+    static std::future<nlohmann::json> rejected(SpError rc, std::pmr::memory_resource* mr);
+    void dispatch_loop();
+    void complete_loop();
+
+    IServiceProvider& sp_;
+    CommandQueueOptions opts_;
+    AdmissionController admission_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;             // dispatcher: new work or a free slot
+    std::condition_variable completion_cv_;  // completer: new in-flight command or stop
+    std::condition_variable idle_cv_;
+    std::deque<Item*> pending_;
+    std::deque<Item*> inflight_q_;           // dispatched, awaiting completion, in order
+    std::size_t inflight_{0};                // dispatched and not yet completed
+    bool stop_{false};
+    CommandQueueStats stats_;
+
+    std::thread dispatcher_;
+    std::thread completer_;
+};
+
+} // namespace atmsp
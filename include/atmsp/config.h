@@ -12,6 +12,14 @@ struct DeviceConfig {
     bool emv{false};
     bool contactless{false};
     bool bypassAllowed{false};
+    // Admission control ("limits"); 0 = unlimited.
+    double commandsPerSec{0};
+    int commandBurst{1};
+    int maxInFlight{0};
+    double eventsPerSec{0};
+    int eventBurst{1};
+    // Printer receipt templates: name -> file, compiled when the device comes up.
+    std::unordered_map<std::string, std::string> templates;
 };
 
 struct LoggingConfig {
@@ -22,8 +30,17 @@ struct LoggingConfig {
     int rotateFiles{3};
 };
 
+struct JournalConfig {
+    bool enabled{false};
+    std::string dir{"logs/journal"};
+    int segmentMB{4};
+    int fsyncMs{50};
+    int maxSegments{16};
+};
+
 struct AppConfig {
     LoggingConfig logging;
+    JournalConfig journal;
     std::unordered_map<std::string, DeviceConfig> devices;
 };
 
@@ -0,0 +1,75 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "config.h"
+#include "errors.h"
+#include "event_bus.h"
+#include "sp_interface.h"
+
+namespace atmsp {
+
+using SpFactory = std::function<std::unique_ptr<IServiceProvider>()>;
+
+struct DeviceStartup {
+    std::string logical;
+    std::string type;
+    SpError result{SpError::Ok};
+    bool timedOut{false};
+    double initMs{0};
+    double openMs{0};
+    double totalMs{0};      // from bring-up start until init+open returned (or the deadline)
+};
+
+struct StartupReport {
+    std::vector<DeviceStartup> devices;   // sorted by logical name
+    double totalMs{0};                    // wall time of the whole bring-up
+    double slowestMs{0};                  // slowest single device
+    std::size_t opened() const;
+};
+
+// Maps config "type" strings to SP factories and owns the opened devices.
+//
+// bring_up() instantiates every configured device with a registered type and
+// runs init()+open() for all of them concurrently, each bounded by its
+// DeviceConfig::openMs, so cold start tracks the slowest device rather than
+// the sum. A device that misses its deadline is reported as Timeout; its
+// open() finishes in the background and the SP is closed and discarded.
+// close_all() (and the destructor) joins those startup threads, so the
+// EventBus passed to bring_up() must outlive that call.
+class DeviceRegistry {
+public:
+    DeviceRegistry();                     // registers the built-in mock SP types
+    ~DeviceRegistry();
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    void register_type(const std::string& type, SpFactory factory);
+    bool has_type(const std::string& type) const { return factories_.count(type) > 0; }
+
+    StartupReport bring_up(const AppConfig& cfg, EventBus& bus);
+
+    // Opened device by logical name, or nullptr.
+    IServiceProvider* get(const std::string& logical) const;
+    template <class T> T* get_as(const std::string& logical) const {
+        return dynamic_cast<T*>(get(logical));
+    }
+    std::vector<std::string> logicals() const;
+
+    // Waits for any startup still running, then closes every opened device.
+    void close_all();
+
+private:
+    std::unordered_map<std::string, SpFactory> factories_;
+    std::map<std::string, std::shared_ptr<IServiceProvider>> devices_;
+    std::vector<std::thread> startup_;    // one per device bring_up() launched
+};
+
+// Logs one line per device plus the total, slowest first.
+void log_startup_report(const StartupReport& r);
+
+} // namespace atmsp
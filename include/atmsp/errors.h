@@ -11,7 +11,10 @@ enum class SpError {
     IoError,
     InvalidCommand,
     Unsupported,
-    Internal
+    Internal,
+    RateLimited,
+    TooManyInFlight,
+    Busy
 };
 inline std::string_view to_string(SpError e) {
     switch (e) {
@@ -24,6 +27,9 @@ inline std::string_view to_string(SpError e) {
         case SpError::InvalidCommand: return "InvalidCommand";
         case SpError::Unsupported: return "Unsupported";
         case SpError::Internal: return "Internal";
+        case SpError::RateLimited: return "RateLimited";
+        case SpError::TooManyInFlight: return "TooManyInFlight";
+        case SpError::Busy: return "Busy";
     }
     return "Unknown";
 }
@@ -1,13 +1,31 @@
 ﻿#pragma once
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <memory_resource>
 #include <mutex>
 #include <vector>
 #include <atomic>
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
 #include "events.h"
+#include "rate_limiter.h"
 
 namespace atmsp {
 
+// Publishing state for one event source (usually a logical device). The bus
+// owns these; references stay valid for the bus lifetime.
+struct EventSource {
+    explicit EventSource(std::string n) : name(std::move(n)) {}
+    const std::string name;
+    TokenBucket limit;                          // unlimited until configured
+    std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> shed{0};         // dropped by the rate limit
+    std::atomic<bool> insert_shed{false};       // last CardInserted was shed
+};
+
 class EventBus {
 public:
     using HandlerId = std::size_t;
@@ -26,7 +44,11 @@ public:
     }
 
     void publish(const Event& e) const {
-        std::vector<Handler> snapshot;
+        // Snapshot into a stack buffer: no heap allocation per publish for
+        // the usual handful of subscribers (spills to the heap beyond that).
+        std::array<std::byte, 1024> buf;
+        std::pmr::monotonic_buffer_resource mr(buf.data(), buf.size());
+        std::pmr::vector<Handler> snapshot(&mr);
         {
             std::lock_guard<std::mutex> lk(mu_);
             snapshot.reserve(handlers_.size());
@@ -35,10 +57,47 @@ public:
         for (auto& h : snapshot) h(e);
     }
 
+    // Returns (creating on first use) the source handle for name. SPs look
+    // theirs up once at open() and publish through it.
+    EventSource& source(const std::string& name) {
+        std::lock_guard<std::mutex> lk(sources_mu_);
+        auto& p = sources_[name];
+        if (!p) p = std::make_unique<EventSource>(name);
+        return *p;
+    }
+
+    void set_rate_limit(const std::string& name, double eventsPerSec, int burst) {
+        source(name).limit.configure(eventsPerSec, burst);
+    }
+
+    // Publishes on behalf of src. Only card presence chatter is rate limited:
+    // a CardInserted over src's limit is shed, and so is the CardRemoved that
+    // pairs with it, so subscribers never see an unpaired removal. Everything
+    // else (track data, PIN, errors, session markers, sensor edges, which the
+    // sensors SP already debounces) always goes through. Returns false if shed.
+    bool publish(EventSource& src, const Event& e) const {
+        bool shed = false;
+        if (std::holds_alternative<CardInserted>(e)) {
+            shed = !src.limit.try_acquire();
+            src.insert_shed.store(shed, std::memory_order_relaxed);
+        } else if (std::holds_alternative<CardRemoved>(e)) {
+            shed = src.insert_shed.exchange(false, std::memory_order_relaxed);
+        }
+        if (shed) {
+            src.shed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        src.published.fetch_add(1, std::memory_order_relaxed);
+        publish(e);
+        return true;
+    }
+
 private:
     mutable std::mutex mu_;
     std::vector<std::pair<HandlerId, Handler>> handlers_;
     std::atomic<HandlerId> next_id_ {0};
+    std::mutex sources_mu_;
+    std::map<std::string, std::unique_ptr<EventSource>> sources_;
 };
 
 } // namespace atmsp
@@ -2,13 +2,14 @@
 #include <string>
 #include <variant>
 #include <chrono>
+#include <cstdint>
+#include <string_view>
+#include "time_source.h"
 
 namespace atmsp {
 
-using Clock = std::chrono::system_clock;
-using TimePoint = std::chrono::time_point<Clock>;
-
-struct BaseEvent { TimePoint ts { Clock::now() }; };
+// Stamped with the monotonic TimeSource; use ts.wall() / format_time(ts) for wall time.
+struct BaseEvent { Timestamp ts { TimeSource::now() }; };
 struct ErrorEvent : BaseEvent { int code {0}; std::string message; };
 
 struct CardInserted : BaseEvent { };
@@ -19,12 +20,27 @@ struct ChipReady    : BaseEvent { bool contactless{false}; };
 struct PinRequested : BaseEvent { int minLen{4}; int maxLen{12}; bool bypassAllowed{false}; };
 struct PinEntered   : BaseEvent { std::string masked; };
 
+enum class SensorKind : std::uint8_t { Door, Tamper, Proximity, Temperature };
+// value: 0/1 for Door/Tamper/Proximity, tenths of a degree C for Temperature.
+struct SensorChanged : BaseEvent { SensorKind sensor{SensorKind::Door}; int value{0}; };
+
 struct SessionStarted : BaseEvent { std::string sessionId; };
 struct SessionEnded   : BaseEvent { std::string sessionId; int resultCode{0}; };
 
 using Event = std::variant<ErrorEvent,
                            CardInserted, CardRemoved, Track2Read, ChipReady,
                            PinRequested, PinEntered,
+                           SensorChanged,
                            SessionStarted, SessionEnded>;
 
+inline std::string_view to_string(SensorKind k) {
+    switch (k) {
+        case SensorKind::Door: return "Door";
+        case SensorKind::Tamper: return "Tamper";
+        case SensorKind::Proximity: return "Proximity";
+        case SensorKind::Temperature: return "Temperature";
+    }
+    return "Unknown";
+}
+
 } // namespace atmsp
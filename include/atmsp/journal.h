@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_bus.h"
+#include "events.h"
+
+namespace atmsp {
+
+// Binary event journal.
+//
+// Every Event published on the bus is appended as a compact record to a
+// memory-mapped, pre-allocated segment file (journal-<seq>.atj). Appends are a
+// memcpy into the mapping; a background thread msyncs dirty ranges every
+// fsyncMs (group commit), pre-allocates and pre-faults the next segment and
+// retires full ones. append() never blocks on the file system: if a segment
+// fills before its replacement is ready, the event is dropped and counted.
+// PAN is masked and raw track data dropped before anything touches the file.
+//
+// Segment layout (little-endian):
+//   SegmentHeader (64 bytes) | Record | Record | ... | zero fill
+// Record:
+//   RecordHeader (16 bytes) | type-specific body, padded to 8 bytes
+// A record with size==0 marks the end of the segment.
+
+struct JournalOptions {
+    std::string dir{"logs/journal"};
+    std::size_t segmentBytes{4 * 1024 * 1024};
+    int fsyncMs{50};            // group-commit interval
+    int maxSegments{16};        // oldest segments beyond this are deleted (0 = keep all)
+};
+
+enum class JournalRecordType : std::uint16_t {
+    Error = 1,
+    CardInserted,
+    CardRemoved,
+    Track2Read,
+    ChipReady,
+    PinRequested,
+    PinEntered,
+    SessionStarted,
+    SessionEnded,
+    SensorChanged,
+};
+
+struct JournalStats {
+    std::uint64_t records{0};
+    std::uint64_t bytes{0};
+    std::uint64_t dropped{0};   // records not written (encode failure or no spare segment yet)
+    std::uint64_t segments{0};  // segments opened
+    std::uint64_t syncs{0};     // group commits issued
+};
+
+namespace detail { class MappedSegment; }
+
+class EventJournal {
+public:
+    explicit EventJournal(JournalOptions opts = {});
+    ~EventJournal();
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    // Opens the first segment and starts the commit thread. Returns false if
+    // the directory or segment cannot be created.
+    bool start();
+    // Flushes everything written so far, truncates the live segment to its
+    // used size and stops the commit thread.
+    void stop();
+
+    // Subscribes the journal to a bus; detach() must run before the bus dies.
+    void attach(EventBus& bus);
+    void detach();
+
+    // Appends one event. Safe to call concurrently from any publisher thread.
+    void append(const Event& e);
+
+    // Forces a synchronous commit of everything appended so far.
+    void flush();
+
+    JournalStats stats() const;
+    const JournalOptions& options() const { return opts_; }
+
+private:
+    std::shared_ptr<detail::MappedSegment> open_segment(std::uint64_t seq);
+    bool rotate_locked();
+    void commit_loop();
+    void commit();
+    void prune();
+
+    JournalOptions opts_;
+
+    mutable std::mutex mu_;                               // guards current_/spare_/retired_
+    std::shared_ptr<detail::MappedSegment> current_;
+    std::shared_ptr<detail::MappedSegment> spare_;        // pre-allocated next segment
+    std::vector<std::shared_ptr<detail::MappedSegment>> retired_;
+    std::uint64_t next_seq_{1};
+    bool spare_pending_{false};
+
+    std::mutex commit_mu_;                                // serialises commit()
+    std::thread committer_;
+    std::mutex cv_mu_;
+    std::condition_variable cv_;
+    std::atomic<bool> wake_{false};
+    bool stop_{false};
+    bool running_{false};
+
+    EventBus* bus_{nullptr};
+    EventBus::HandlerId sub_{0};
+
+    std::atomic<std::uint64_t> records_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> segments_{0};
+    std::atomic<std::uint64_t> syncs_{0};
+};
+
+struct JournalRecord {
+    std::int64_t tsNs{0};       // wall-clock ns since epoch at publish time
+    bool panMasked{false};
+    Event event;
+};
+
+// Sequential reader over every segment in a journal directory, oldest first.
+class JournalReader {
+public:
+    explicit JournalReader(const std::string& dir);
+
+    // Returns the next record, or std::nullopt at the end of the journal.
+    std::optional<JournalRecord> next();
+
+    std::size_t segment_count() const { return files_.size(); }
+
+private:
+    bool load_next_segment();
+
+    std::vector<std::string> files_;
+    std::size_t file_idx_{0};
+    std::vector<char> buf_;
+    std::size_t pos_{0};
+};
+
+// Lists journal segment files in dir, sorted by sequence number.
+std::vector<std::string> list_journal_segments(const std::string& dir);
+
+} // namespace atmsp
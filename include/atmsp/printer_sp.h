@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include "receipt_template.h"
+#include "sp_interface.h"
+
+namespace atmsp {
+
+struct PrinterOptions {
+    std::size_t spoolCapacity{32};   // queued receipts before print() reports Busy
+    // Simulated device speed (mock only).
+    int msPerLine{8};
+    int cutMs{150};
+};
+
+struct PrinterStats {
+    std::uint64_t submitted{0};      // accepted into the spool
+    std::uint64_t printed{0};
+    std::uint64_t rejected{0};       // spool full
+    std::size_t   queued{0};         // waiting in the spool now
+    std::size_t   peakQueued{0};
+};
+
+struct PrintTicket {
+    SpError result{SpError::Ok};     // Busy when the spool is full
+    std::uint64_t jobId{0};
+};
+
+class IPrinterSP : public IServiceProvider {
+public:
+    virtual ~IPrinterSP() = default;
+
+    // Compiles text and registers it under name, replacing any previous one.
+    virtual SpError load_template(const std::string& name, std::string_view text,
+                                  std::string* error = nullptr) = 0;
+    virtual std::shared_ptr<const ReceiptTemplate> find_template(const std::string& name) const = 0;
+
+    // Renders on the caller's thread and hands the receipt to the spool;
+    // never waits for the device.
+    virtual PrintTicket print(const ReceiptTemplate& t, std::span<const std::string_view> values) = 0;
+
+    // Waits until the spool is empty and the device is idle. False on timeout.
+    virtual bool wait_idle(int timeoutMs) = 0;
+    virtual PrinterStats stats() const = 0;
+};
+
+} // namespace atmsp
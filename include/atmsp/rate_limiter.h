@@ -0,0 +1,129 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "errors.h"
+#include "time_source.h"
+
+namespace atmsp {
+
+// Lock-free token bucket, implemented as GCRA: a single atomic "theoretical
+// arrival time" replaces the token count and refill timestamp. Admitting a
+// request is one load and one CAS; an unlimited bucket (rate 0) is one load.
+class TokenBucket {
+public:
+    TokenBucket() = default;
+    TokenBucket(double ratePerSec, int burst) { configure(ratePerSec, burst); }
+
+    // ratePerSec <= 0 disables the limit. burst is the number of requests
+    // accepted back-to-back from an idle bucket.
+    void configure(double ratePerSec, int burst) {
+        const std::int64_t interval = ratePerSec > 0.0
+            ? std::max<std::int64_t>(static_cast<std::int64_t>(1e9 / ratePerSec), 1) : 0;
+        interval_.store(interval, std::memory_order_relaxed);
+        window_.store(interval * std::max(burst, 1), std::memory_order_relaxed);
+    }
+
+    bool limited() const { return interval_.load(std::memory_order_relaxed) != 0; }
+
+    bool try_acquire() { return limited() ? try_acquire(TimeSource::now_ns()) : true; }
+    bool try_acquire(std::int64_t nowNs) { return try_acquire_n(1, nowNs); }
+
+    // Takes n tokens at once or none at all. n above the burst can never fit
+    // the window, so such a request is granted only from a full (idle) bucket
+    // and the overdraft is paid back before anything else is admitted.
+    bool try_acquire_n(int n) { return limited() ? try_acquire_n(n, TimeSource::now_ns()) : true; }
+
+    bool try_acquire_n(int n, std::int64_t nowNs) {
+        const std::int64_t interval = interval_.load(std::memory_order_relaxed);
+        if (interval == 0) return true;
+        const std::int64_t window = window_.load(std::memory_order_relaxed);
+        std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        const std::int64_t cost = interval * n;
+        for (;;) {
+            const std::int64_t next = std::max(tat, nowNs) + cost;
+            const bool fits = cost > window ? tat <= nowNs : next - nowNs <= window;
+            if (!fits) return false;
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) return true;
+        }
+    }
+
+private:
+    std::atomic<std::int64_t> interval_{0};   // ns per token; 0 = unlimited
+    std::atomic<std::int64_t> window_{0};     // interval * burst
+    std::atomic<std::int64_t> tat_{0};
+};
+
+struct AdmissionLimits {
+    double commandsPerSec{0};   // 0 = unlimited
+    int commandBurst{1};
+    int maxInFlight{0};         // 0 = unlimited
+};
+
+struct AdmissionStats {
+    std::uint64_t admitted{0};
+    std::uint64_t rateLimited{0};
+    std::uint64_t overInFlight{0};
+};
+
+// Command admission for one logical device: a token bucket on submissions
+// plus a cap on commands accepted but not yet completed. Lock-free.
+class AdmissionController {
+public:
+    AdmissionController() = default;
+    explicit AdmissionController(const AdmissionLimits& l) { configure(l); }
+
+    void configure(const AdmissionLimits& l) {
+        bucket_.configure(l.commandsPerSec, l.commandBurst);
+        max_inflight_.store(std::max(l.maxInFlight, 0), std::memory_order_relaxed);
+    }
+
+    // Admits n commands together or none of them: Ok, SpError::TooManyInFlight
+    // or SpError::RateLimited. An Ok must be paired with release(n) in total
+    // once the commands complete. A group larger than the in-flight cap or the
+    // burst is admitted only when the device is idle, so retrying it succeeds
+    // once earlier work has drained.
+    SpError try_admit(int n = 1) {
+        const int cap = max_inflight_.load(std::memory_order_relaxed);
+        bool fits = true;
+        if (cap > 0 && n > cap) {
+            int idle = 0;
+            fits = inflight_.compare_exchange_strong(idle, n, std::memory_order_acq_rel);
+        } else {
+            const int total = inflight_.fetch_add(n, std::memory_order_acq_rel) + n;
+            if (cap > 0 && total > cap) {
+                inflight_.fetch_sub(n, std::memory_order_acq_rel);
+                fits = false;
+            }
+        }
+        if (!fits) {
+            over_inflight_.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+            return SpError::TooManyInFlight;
+        }
+        if (!bucket_.try_acquire_n(n)) {
+            inflight_.fetch_sub(n, std::memory_order_acq_rel);
+            rate_limited_.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+            return SpError::RateLimited;
+        }
+        admitted_.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+        return SpError::Ok;
+    }
+
+    void release(int n = 1) { inflight_.fetch_sub(n, std::memory_order_acq_rel); }
+
+    int inflight() const { return inflight_.load(std::memory_order_relaxed); }
+
+    AdmissionStats stats() const {
+        return { admitted_.load(), rate_limited_.load(), over_inflight_.load() };
+    }
+
+private:
+    TokenBucket bucket_;
+    std::atomic<int> max_inflight_{0};
+    std::atomic<int> inflight_{0};
+    std::atomic<std::uint64_t> admitted_{0};
+    std::atomic<std::uint64_t> rate_limited_{0};
+    std::atomic<std::uint64_t> over_inflight_{0};
+};
+
+} // namespace atmsp
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace atmsp {
+
+// Receipt layout compiled once at load time.
+//
+// Syntax: literal text with {{field}} placeholders; {{field:<N}} and
+// {{field:>N}} pad the value to N columns, left- or right-aligned. compile()
+// splits the text into literal and field segments and resolves every
+// placeholder to a field index, so render() is a run of appends with no
+// parsing or name lookups.
+class ReceiptTemplate {
+public:
+    // Returns std::nullopt (and a message in *error) on malformed input.
+    static std::optional<ReceiptTemplate> compile(std::string_view text, std::string* error = nullptr);
+
+    // Distinct field names, in order of first use; render() takes values in this order.
+    const std::vector<std::string>& fields() const { return fields_; }
+    int field_index(std::string_view name) const;   // -1 if unknown
+
+    // Appends the receipt to out. values[i] fills fields()[i]; missing values render empty.
+    void render(std::span<const std::string_view> values, std::string& out) const;
+
+    // Slow path for JSON callers: looks each field up by name (strings or numbers).
+    void render_json(const nlohmann::json& values, std::string& out) const;
+
+private:
+    struct Segment {
+        std::uint32_t offset{0};   // literal: into literals_
+        std::uint32_t length{0};
+        std::int32_t  field{-1};   // >= 0: placeholder
+        std::uint16_t width{0};
+        bool          right{false};
+    };
+
+    std::string literals_;
+    std::vector<Segment> segments_;
+    std::vector<std::string> fields_;
+};
+
+} // namespace atmsp
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include "events.h"
+#include "sp_interface.h"
+
+namespace atmsp {
+
+// Compact per-scan sensor state: one bit per digital sensor, one 16-bit
+// reading per analog sensor. Indices follow SensorKind.
+struct SensorSnapshot {
+    static constexpr std::size_t kDigital = 3;   // Door, Tamper, Proximity
+    static constexpr std::size_t kAnalog  = 1;   // Temperature
+    static constexpr std::size_t kCount   = kDigital + kAnalog;
+
+    std::bitset<kDigital> digital;
+    std::array<std::int16_t, kAnalog> analog{};  // tenths of a degree C
+
+    int value(std::size_t i) const {
+        return i < kDigital ? static_cast<int>(digital[i]) : analog[i - kDigital];
+    }
+};
+
+// Source of raw sensor readings (hardware, XFS SIU, or a mock).
+class ISensorBackend {
+public:
+    virtual ~ISensorBackend() = default;
+    virtual void read(SensorSnapshot& out, std::int64_t nowNs) = 0;
+};
+
+struct SensorOptions {
+    // Adaptive polling: drop to minPollUs while anything is changing, back
+    // off (doubling) towards maxPollUs while the sensors are quiet.
+    int minPollUs{1000};
+    int maxPollUs{20000};
+    // A changed reading must hold this long before it is published.
+    std::array<int, SensorSnapshot::kCount> debounceMs{ 20, 5, 50, 500 };
+    // Analog changes smaller than this (in sensor units) are noise.
+    int analogHysteresis{5};
+};
+
+struct SensorStats {
+    std::uint64_t scans{0};
+    std::uint64_t rawTransitions{0};   // per-sensor changes seen scan-to-scan
+    std::uint64_t published{0};        // SensorChanged events published
+    std::int64_t  pollUs{0};           // current poll interval
+};
+
+// Change detection + debounce over successive snapshots. Not thread-safe.
+//
+// Each scan is XOR-ed against the last published (stable) state; sensors that
+// match it cost nothing. A differing sensor must keep differing for its
+// debounce window before it becomes stable and is emitted, so contact bounce
+// and chatter shorter than the window never reach the bus.
+class SensorFilter {
+public:
+    explicit SensorFilter(const SensorOptions& o = {}) : opts_(o) {}
+
+    void reset(const SensorSnapshot& initial) {
+        stable_ = initial;
+        last_ = initial;
+        pending_.reset();
+    }
+
+    // Feeds one scan. Calls emit(SensorKind, value) for every sensor whose
+    // change has outlasted its debounce window. Returns true while any sensor
+    // still differs from the stable state (drives adaptive polling).
+    template <class Emit>
+    bool update(const SensorSnapshot& raw, std::int64_t nowNs, Emit&& emit) {
+        constexpr auto kD = SensorSnapshot::kDigital;
+        raw_transitions_ += (raw.digital ^ last_.digital).count();
+        for (std::size_t a = 0; a < SensorSnapshot::kAnalog; ++a)
+            if (raw.analog[a] != last_.analog[a]) ++raw_transitions_;
+        last_ = raw;
+
+        const auto diff = raw.digital ^ stable_.digital;
+        bool analogDiff = false;
+        for (std::size_t a = 0; a < SensorSnapshot::kAnalog; ++a)
+            analogDiff |= std::abs(raw.analog[a] - stable_.analog[a]) >= opts_.analogHysteresis;
+        if (diff.none() && !analogDiff && pending_.none()) return false;   // quiet scan
+
+        for (std::size_t i = 0; i < SensorSnapshot::kCount; ++i) {
+            const bool differs = i < kD
+                ? diff[i]
+                : std::abs(raw.analog[i - kD] - stable_.analog[i - kD]) >= opts_.analogHysteresis;
+            if (!differs) { pending_.reset(i); continue; }
+            if (!pending_[i]) { pending_.set(i); since_[i] = nowNs; }
+            if (nowNs - since_[i] >= static_cast<std::int64_t>(opts_.debounceMs[i]) * 1'000'000) {
+                if (i < kD) stable_.digital[i] = raw.digital[i];
+                else stable_.analog[i - kD] = raw.analog[i - kD];
+                pending_.reset(i);
+                emit(static_cast<SensorKind>(i), stable_.value(i));
+            }
+        }
+        return diff.any() || analogDiff;
+    }
+
+    const SensorSnapshot& stable() const { return stable_; }
+    std::uint64_t raw_transitions() const { return raw_transitions_; }
+    SensorOptions& options() { return opts_; }
+
+private:
+    SensorOptions opts_;
+    SensorSnapshot stable_;
+    SensorSnapshot last_;
+    std::bitset<SensorSnapshot::kCount> pending_;
+    std::array<std::int64_t, SensorSnapshot::kCount> since_{};
+    std::uint64_t raw_transitions_{0};
+};
+
+class ISensorsSP : public IServiceProvider {
+public:
+    virtual ~ISensorsSP() = default;
+    virtual SensorStats stats() const = 0;
+};
+
+// Mock backend: a door that opens/closes every few seconds with contact
+// bounce, a chattering proximity sensor, and a noisy temperature probe.
+std::unique_ptr<ISensorBackend> make_noisy_sensor_backend(std::uint32_t seed = 1);
+
+} // namespace atmsp
@@ -1,20 +1,34 @@
 ﻿#pragma once
 #include <string>
+#include <future>
+#include <memory>
+#include <memory_resource>
 #include <nlohmann/json.hpp>
 #include "event_bus.h"
 #include "events.h"
+#include "session_arena.h"
 
 namespace atmsp {
 
 enum class SessionState { Idle, Active, Ended };
 
+// A transaction. While Active, the session owns a SessionArena from its pool
+// (pass pool=nullptr to opt out); short-lived per-transaction data such as
+// command completions can allocate from resource(). The arena is released
+// wholesale when the session ends.
 class Session {
 public:
-    Session(std::string id, EventBus& bus) : id_(std::move(id)), bus_(bus) {}
+    Session(std::string id, EventBus& bus, ArenaPool* pool = &ArenaPool::shared())
+        : id_(std::move(id)), bus_(bus), pool_(pool) {}
+    ~Session() { release_arena(); }
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
     const std::string& id() const { return id_; }
     SessionState state() const { return state_; }
 
     void start() {
+        if (pool_ && !arena_) arena_ = pool_->acquire();
         state_ = SessionState::Active;
         bus_.publish(SessionStarted{.sessionId = id_});
     }
@@ -22,12 +36,31 @@ public:
     void end(int resultCode = 0) {
         state_ = SessionState::Ended;
         bus_.publish(SessionEnded{.sessionId = id_, .resultCode = resultCode});
+        release_arena();
+    }
+
+    // Session arena while Active, otherwise the default heap resource.
+    std::pmr::memory_resource* resource() const {
+        return arena_ ? static_cast<std::pmr::memory_resource*>(arena_) : std::pmr::get_default_resource();
+    }
+    const SessionArena* arena() const { return arena_; }
+
+    // Promise whose shared state lives in the session arena.
+    template <class T> std::promise<T> make_promise() const {
+        return std::promise<T>(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(resource()));
     }
 
 private:
+    void release_arena() {
+        if (arena_) arena_->retire();
+        arena_ = nullptr;
+    }
+
     std::string id_;
     SessionState state_ { SessionState::Idle };
     EventBus& bus_;
+    ArenaPool* pool_;
+    SessionArena* arena_ {nullptr};
 };
 
 } // namespace atmsp
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace atmsp {
+
+class ArenaPool;
+
+// Session-scoped monotonic arena.
+//
+// Allocation is a pointer bump inside blocks owned by the arena; deallocation
+// is free. Publishers run on SP threads, so the arena is internally locked.
+// It counts live allocations: when the owning Session ends the arena is
+// retired, and it is reset and handed back to its pool as soon as the last
+// allocation made from it is released (immediately, in the common case).
+class SessionArena final : public std::pmr::memory_resource {
+public:
+    struct Stats {
+        std::uint64_t allocations{0};   // since the last reset
+        std::size_t   bytes{0};         // requested since the last reset
+        std::size_t   live{0};          // allocations not yet deallocated
+    };
+
+    explicit SessionArena(std::size_t initialBytes, ArenaPool* pool = nullptr);
+    ~SessionArena() override = default;
+
+    // Marks the end of the owning session; recycles now or on last release.
+    void retire();
+
+    Stats stats() const;
+
+private:
+    friend class ArenaPool;
+    void* do_allocate(std::size_t bytes, std::size_t align) override;
+    void  do_deallocate(void* p, std::size_t bytes, std::size_t align) override;
+    bool  do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+    void  reset();
+
+    ArenaPool* pool_;
+    std::unique_ptr<std::byte[]> initial_;
+    std::size_t initial_size_;
+    std::pmr::monotonic_buffer_resource mono_;
+    mutable std::mutex mu_;
+    Stats stats_;
+    bool retired_{false};
+};
+
+struct ArenaPoolStats {
+    std::size_t owned{0};       // arenas currently owned by the pool
+    std::size_t idle{0};        // ready for reuse
+    std::size_t draining{0};    // retired, waiting for live allocations to go
+};
+
+// Recycles SessionArenas so steady-state transactions allocate no new blocks.
+class ArenaPool {
+public:
+    explicit ArenaPool(std::size_t arenaBytes = 16 * 1024, std::size_t maxIdle = 64);
+    ~ArenaPool();
+    ArenaPool(const ArenaPool&) = delete;
+    ArenaPool& operator=(const ArenaPool&) = delete;
+
+    // Process-wide pool used by Session by default.
+    static ArenaPool& shared();
+
+    // Returns an idle arena or creates one. The pool keeps ownership; give it
+    // back with SessionArena::retire().
+    SessionArena* acquire();
+
+    ArenaPoolStats stats() const;
+
+private:
+    friend class SessionArena;
+    void recycle(SessionArena* a);
+
+    std::size_t arena_bytes_;
+    std::size_t max_idle_;
+    mutable std::mutex mu_;
+    std::vector<std::unique_ptr<SessionArena>> all_;
+    std::vector<SessionArena*> idle_;
+};
+
+} // namespace atmsp
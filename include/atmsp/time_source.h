@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace atmsp {
+
+// Low-cost time service.
+//
+// TimeSource::now() reads a calibrated TSC on x86-64 CPUs with an invariant
+// TSC and falls back to std::chrono::steady_clock elsewhere (or when
+// ATMSP_NO_TSC is set). Stamps are monotonic nanoseconds; wall-clock time is
+// only computed when someone asks for it, from an offset that is re-anchored
+// to system_clock at most once a second, so TSC calibration error and NTP
+// adjustments never accumulate.
+
+struct Timestamp {
+    std::int64_t ns{0};   // monotonic ns since the TimeSource epoch
+
+    std::int64_t wall_ns() const noexcept;                        // ns since Unix epoch
+    std::chrono::system_clock::time_point wall() const noexcept;
+    static Timestamp from_wall_ns(std::int64_t wallNs) noexcept;
+
+    friend auto operator<=>(const Timestamp&, const Timestamp&) = default;
+    friend std::int64_t operator-(Timestamp a, Timestamp b) noexcept { return a.ns - b.ns; }
+};
+
+class TimeSource {
+public:
+    static std::int64_t now_ns() noexcept;
+    static Timestamp now() noexcept { return Timestamp{now_ns()}; }
+
+    // Re-anchors monotonic->wall conversion to the current system clock now.
+    // Timestamp::wall_ns() already does this on its own once the anchor is
+    // older than a second. Cheap; safe to call from any thread.
+    static void resync() noexcept;
+
+    // "tsc" or "steady" — which path now_ns() is using.
+    static std::string_view backend() noexcept;
+};
+
+// Elapsed-time helper for latency measurements.
+class Stopwatch {
+public:
+    Stopwatch() : start_(TimeSource::now_ns()) {}
+    void reset() { start_ = TimeSource::now_ns(); }
+    std::int64_t elapsed_ns() const { return TimeSource::now_ns() - start_; }
+    double elapsed_ms() const { return static_cast<double>(elapsed_ns()) / 1e6; }
+private:
+    std::int64_t start_;
+};
+
+// Formatted local time, "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DD HH:MM:SS.mmm".
+struct TimeText {
+    char data[32]{};
+    std::size_t len{0};
+    std::string_view view() const { return {data, len}; }
+    std::string str() const { return std::string(view()); }
+};
+
+// Formats a timestamp as local time. The "YYYY-MM-DD HH:MM:SS" prefix is cached
+// per thread and only recomputed (localtime + strftime) when the second changes.
+TimeText format_time(Timestamp ts, bool millis = false);
+TimeText format_wall_ns(std::int64_t wallNs, bool millis = false);
+
+} // namespace atmsp
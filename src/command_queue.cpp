@@ -0,0 +1,178 @@
+#include "atmsp/command_queue.h"
+#include <algorithm>
+
+namespace atmsp {
+
+CommandQueue::CommandQueue(IServiceProvider& sp, CommandQueueOptions opts)
+    : sp_(sp), opts_(std::move(opts)), admission_(opts_.admission) {
+    opts_.maxInFlight = std::max<std::size_t>(opts_.maxInFlight, 1);
+    dispatcher_ = std::thread([this]{ dispatch_loop(); });
+    completer_  = std::thread([this]{ complete_loop(); });
+}
+
+CommandQueue::~CommandQueue() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    completion_cv_.notify_all();
+    if (dispatcher_.joinable()) dispatcher_.join();
+    if (completer_.joinable()) completer_.join();
+}
+
+std::future<nlohmann::json> CommandQueue::submit(std::string command, nlohmann::json payload,
+                                                 std::pmr::memory_resource* mr) {
+    if (const auto rc = admission_.try_admit(); rc != SpError::Ok) {
+        std::lock_guard<std::mutex> lk(mu_);
+        ++stats_.rejected;
+        return rejected(rc, mr);
+    }
+    std::future<nlohmann::json> fut;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        fut = enqueue_locked(DeviceCommand{std::move(command), std::move(payload)}, mr);
+    }
+    cv_.notify_one();
+    return fut;
+}
+
+std::vector<std::future<nlohmann::json>> CommandQueue::executeBatch(std::vector<DeviceCommand> cmds,
+                                                                    std::pmr::memory_resource* mr) {
+    // All or nothing: a setup batch must never run with a hole in the middle.
+    const SpError verdict = cmds.empty() ? SpError::Ok
+                                         : admission_.try_admit(static_cast<int>(cmds.size()));
+
+    std::vector<std::future<nlohmann::json>> futs;
+    futs.reserve(cmds.size());
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (auto& cmd : cmds) {
+            if (verdict == SpError::Ok) {
+                futs.push_back(enqueue_locked(std::move(cmd), mr));
+            } else {
+                ++stats_.rejected;
+                futs.push_back(rejected(verdict, mr));
+            }
+        }
+    }
+    cv_.notify_one();
+    return futs;
+}
+
+void CommandQueue::drain() {
+    std::unique_lock<std::mutex> lk(mu_);
+    idle_cv_.wait(lk, [&]{ return pending_.empty() && inflight_ == 0; });
+}
+
+CommandQueueStats CommandQueue::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+std::promise<nlohmann::json> CommandQueue::make_promise(std::pmr::memory_resource* mr) {
+    if (!mr) return {};
+    return std::promise<nlohmann::json>(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(mr));
+}
+
+std::future<nlohmann::json> CommandQueue::rejected(SpError rc, std::pmr::memory_resource* mr) {
+    auto p = make_promise(mr);
+    p.set_value(nlohmann::json{{"ok", false}, {"error", std::string(to_string(rc))}});
+    return p.get_future();
+}
+
+CommandQueue::Item* CommandQueue::new_item(std::pmr::memory_resource* mr) {
+    if (!mr) mr = std::pmr::get_default_resource();
+    return std::pmr::polymorphic_allocator<std::byte>(mr).new_object<Item>(mr);
+}
+
+void CommandQueue::delete_item(Item* item) {
+    std::pmr::polymorphic_allocator<std::byte>(item->mr).delete_object(item);
+}
+
+std::future<nlohmann::json> CommandQueue::enqueue_locked(DeviceCommand cmd, std::pmr::memory_resource* mr) {
+    auto p = make_promise(mr);
+    auto fut = p.get_future();
+    ++stats_.submitted;
+
+    const bool coalescible = opts_.coalesce.count(cmd.command) > 0;
+    if (coalescible) {
+        // Only look through the trailing run of setters: folding across any
+        // other command would change what that command observes.
+        for (auto it = pending_.rbegin(); it != pending_.rend() && (*it)->coalescible; ++it) {
+            if ((*it)->cmd.command == cmd.command) {
+                (*it)->cmd.payload = std::move(cmd.payload);
+                (*it)->waiters.push_back(std::move(p));
+                ++stats_.coalesced;
+                return fut;
+            }
+        }
+    }
+
+    Item* item = new_item(mr);
+    item->cmd = std::move(cmd);
+    item->coalescible = coalescible;
+    item->waiters.push_back(std::move(p));
+    pending_.push_back(item);
+    return fut;
+}
+
+void CommandQueue::dispatch_loop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        cv_.wait(lk, [&]{
+            return (stop_ && pending_.empty()) || (!pending_.empty() && inflight_ < opts_.maxInFlight);
+        });
+        if (pending_.empty()) break;   // stop_ with nothing left to send
+
+        // Take the next command in submission order.
+        Item* item = pending_.front();
+        pending_.pop_front();
+        ++inflight_;
+        ++stats_.dispatched;
+        stats_.peakInFlight = std::max(stats_.peakInFlight, inflight_);
+        lk.unlock();
+
+        try {
+            item->reply = sp_.execute(item->cmd.command, item->cmd.payload);
+        } catch (...) {
+            std::promise<nlohmann::json> failed;
+            failed.set_exception(std::current_exception());
+            item->reply = failed.get_future();
+        }
+
+        lk.lock();
+        inflight_q_.push_back(item);
+        completion_cv_.notify_one();
+    }
+    completion_cv_.notify_one();   // let the completer see that dispatch is over
+}
+
+void CommandQueue::complete_loop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        completion_cv_.wait(lk, [&]{
+            return !inflight_q_.empty() || (stop_ && pending_.empty() && inflight_ == 0);
+        });
+        if (inflight_q_.empty()) return;
+
+        // Complete the oldest command; completions stay in order.
+        Item* item = inflight_q_.front();
+        inflight_q_.pop_front();
+        lk.unlock();
+        try {
+            const auto reply = item->reply.get();
+            for (auto& w : item->waiters) w.set_value(reply);
+        } catch (...) {
+            for (auto& w : item->waiters) w.set_exception(std::current_exception());
+        }
+        admission_.release(static_cast<int>(item->waiters.size()));
+        delete_item(item);
+        lk.lock();
+        --inflight_;
+        cv_.notify_one();   // a pipeline slot is free
+        if (pending_.empty() && inflight_ == 0) idle_cv_.notify_all();
+    }
+}
+
+} // namespace atmsp
@@ -10,6 +10,10 @@ static int as_int(const json& j, const char* k, int def) {
     if (j.contains(k) && j[k].is_number_integer()) return j[k].get<int>();
     return def;
 }
+static double as_double(const json& j, const char* k, double def) {
+    if (j.contains(k) && j[k].is_number()) return j[k].get<double>();
+    return def;
+}
 static bool as_bool(const json& j, const char* k, bool def) {
     if (j.contains(k) && j[k].is_boolean()) return j[k].get<bool>();
     return def;
@@ -35,6 +39,15 @@ std::optional<AppConfig> load_config(const std::string& path) {
         cfg.logging.rotateFiles = as_int(L, "rotateFiles", 3);
     }
 
+    if (j.contains("journal") && j["journal"].is_object()) {
+        auto J = j["journal"];
+        cfg.journal.enabled     = as_bool(J, "enabled", false);
+        cfg.journal.dir         = as_str(J, "dir", "logs/journal");
+        cfg.journal.segmentMB   = as_int(J, "segmentMB", 4);
+        cfg.journal.fsyncMs     = as_int(J, "fsyncMs", 50);
+        cfg.journal.maxSegments = as_int(J, "maxSegments", 16);
+    }
+
     if (j.contains("devices") && j["devices"].is_object()) {
         for (auto it = j["devices"].begin(); it != j["devices"].end(); ++it) {
             DeviceConfig dc;
@@ -54,6 +67,23 @@ std::optional<AppConfig> load_config(const std::string& path) {
                     dc.bypassAllowed = as_bool(F, "bypassAllowed", dc.bypassAllowed);
                 }
             }
+            if (it.value().contains("limits")) {
+                const auto& Lm = it.value()["limits"];
+                if (Lm.is_object()) {
+                    dc.commandsPerSec = as_double(Lm, "commandsPerSec", dc.commandsPerSec);
+                    dc.commandBurst   = as_int(Lm, "commandBurst", dc.commandBurst);
+                    dc.maxInFlight    = as_int(Lm, "maxInFlight", dc.maxInFlight);
+                    dc.eventsPerSec   = as_double(Lm, "eventsPerSec", dc.eventsPerSec);
+                    dc.eventBurst     = as_int(Lm, "eventBurst", dc.eventBurst);
+                }
+            }
+            if (it.value().contains("templates")) {
+                const auto& Tp = it.value()["templates"];
+                if (Tp.is_object()) {
+                    for (auto t = Tp.begin(); t != Tp.end(); ++t)
+                        if (t.value().is_string()) dc.templates[t.key()] = t.value().get<std::string>();
+                }
+            }
             cfg.devices.emplace(it.key(), dc);
         }
     }
@@ -0,0 +1,176 @@
+#include "atmsp/device_registry.h"
+#include "atmsp/card_reader_sp.h"
+#include "atmsp/pin_pad_sp.h"
+#include "atmsp/printer_sp.h"
+#include "atmsp/sensors_sp.h"
+#include "atmsp/logging.h"
+#include "atmsp/time_source.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace atmsp {
+
+std::unique_ptr<ICardReaderSP> make_mock_card_reader();
+std::unique_ptr<IPinPadSP>    make_mock_pin_pad();
+std::unique_ptr<ISensorsSP>   make_mock_sensors();
+std::unique_ptr<IPrinterSP>   make_mock_printer();
+
+namespace {
+
+// Shared between bring_up() and the device's startup thread, which may
+// outlive the wait if the device misses its deadline.
+struct StartupState {
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done{false};
+    bool abandoned{false};
+    SpError result{SpError::Ok};
+    double initMs{0};
+    double openMs{0};
+    double finishedAtMs{0};
+};
+
+} // namespace
+
+std::size_t StartupReport::opened() const {
+    return static_cast<std::size_t>(std::count_if(devices.begin(), devices.end(),
+        [](const DeviceStartup& d){ return d.result == SpError::Ok; }));
+}
+
+DeviceRegistry::DeviceRegistry() {
+    register_type("card_reader", []{ return std::unique_ptr<IServiceProvider>(make_mock_card_reader()); });
+    register_type("pin_pad",     []{ return std::unique_ptr<IServiceProvider>(make_mock_pin_pad()); });
+    register_type("sensors",     []{ return std::unique_ptr<IServiceProvider>(make_mock_sensors()); });
+    register_type("printer",     []{ return std::unique_ptr<IServiceProvider>(make_mock_printer()); });
+}
+
+DeviceRegistry::~DeviceRegistry() { close_all(); }
+
+void DeviceRegistry::register_type(const std::string& type, SpFactory factory) {
+    factories_[type] = std::move(factory);
+}
+
+StartupReport DeviceRegistry::bring_up(const AppConfig& cfg, EventBus& bus) {
+    struct Pending {
+        std::string logical;
+        std::string type;
+        int openMs{0};
+        std::shared_ptr<IServiceProvider> sp;
+        std::shared_ptr<StartupState> state;
+    };
+
+    StartupReport report;
+    std::vector<Pending> pending;
+    Stopwatch sw;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (const auto& [logical, dc] : cfg.devices) {
+        if (devices_.count(logical)) continue;   // already up
+        auto f = factories_.find(dc.type);
+        if (f == factories_.end()) {
+            spdlog::warn("[Registry] '{}': no SP registered for type '{}'", logical, dc.type);
+            report.devices.push_back({ .logical = logical, .type = dc.type, .result = SpError::Unsupported });
+            continue;
+        }
+        Pending p;
+        p.logical = logical;
+        p.type = dc.type;
+        p.openMs = std::max(dc.openMs, 1);
+        p.sp = std::shared_ptr<IServiceProvider>(f->second());
+        p.state = std::make_shared<StartupState>();
+        pending.push_back(std::move(p));
+    }
+
+    // Launch everything first, then wait; each device runs on its own thread.
+    // The threads are kept and joined in close_all(): one that misses its
+    // deadline still uses bus until its open() returns.
+    for (auto& p : pending) {
+        startup_.emplace_back([sp = p.sp, st = p.state, logical = p.logical, &bus, sw]{
+            Stopwatch step;
+            SpError rc = sp->init(&bus);
+            const double initMs = step.elapsed_ms();
+            step.reset();
+            if (rc == SpError::Ok) rc = sp->open(logical);
+            const double openMs = step.elapsed_ms();
+
+            std::lock_guard<std::mutex> lk(st->mu);
+            st->result = rc;
+            st->initMs = initMs;
+            st->openMs = openMs;
+            st->finishedAtMs = sw.elapsed_ms();
+            st->done = true;
+            // Nobody is waiting any more: tidy up a device that opened late.
+            if (st->abandoned && rc == SpError::Ok) sp->close();
+            st->cv.notify_all();
+        });
+    }
+
+    for (auto& p : pending) {
+        DeviceStartup d;
+        d.logical = p.logical;
+        d.type = p.type;
+
+        std::unique_lock<std::mutex> lk(p.state->mu);
+        const bool done = p.state->cv.wait_until(lk, t0 + std::chrono::milliseconds(p.openMs),
+                                                 [&]{ return p.state->done; });
+        if (done) {
+            d.result  = p.state->result;
+            d.initMs  = p.state->initMs;
+            d.openMs  = p.state->openMs;
+            d.totalMs = p.state->finishedAtMs;
+        } else {
+            p.state->abandoned = true;
+            d.result   = SpError::Timeout;
+            d.timedOut = true;
+            d.totalMs  = static_cast<double>(p.openMs);
+        }
+        lk.unlock();
+
+        if (d.result == SpError::Ok) devices_[p.logical] = p.sp;
+        else spdlog::warn("[Registry] '{}' ({}) failed to start: {}", d.logical, d.type, to_string(d.result));
+        report.devices.push_back(std::move(d));
+    }
+
+    std::sort(report.devices.begin(), report.devices.end(),
+              [](const DeviceStartup& a, const DeviceStartup& b){ return a.logical < b.logical; });
+    report.totalMs = sw.elapsed_ms();
+    for (const auto& d : report.devices) report.slowestMs = std::max(report.slowestMs, d.totalMs);
+    return report;
+}
+
+IServiceProvider* DeviceRegistry::get(const std::string& logical) const {
+    auto it = devices_.find(logical);
+    return it == devices_.end() ? nullptr : it->second.get();
+}
+
+std::vector<std::string> DeviceRegistry::logicals() const {
+    std::vector<std::string> out;
+    out.reserve(devices_.size());
+    for (const auto& [logical, _] : devices_) out.push_back(logical);
+    return out;
+}
+
+void DeviceRegistry::close_all() {
+    for (auto& t : startup_) if (t.joinable()) t.join();
+    startup_.clear();
+    for (auto& [_, sp] : devices_) sp->close();
+    devices_.clear();
+}
+
+void log_startup_report(const StartupReport& r) {
+    auto rows = r.devices;
+    std::sort(rows.begin(), rows.end(),
+              [](const DeviceStartup& a, const DeviceStartup& b){ return a.totalMs > b.totalMs; });
+    for (const auto& d : rows) {
+        spdlog::info("[Startup] {:<12} {:<12} {:<11} init={:.1f}ms open={:.1f}ms ready@{:.1f}ms",
+                     d.logical, d.type, to_string(d.result), d.initMs, d.openMs, d.totalMs);
+    }
+    spdlog::info("[Startup] {}/{} devices up in {:.1f}ms (slowest {:.1f}ms)",
+                 r.opened(), r.devices.size(), r.totalMs, r.slowestMs);
+}
+
+} // namespace atmsp
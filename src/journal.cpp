@@ -0,0 +1,663 @@
+#include "atmsp/journal.h"
+#include "atmsp/logging.h"
+#include "atmsp/redact.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace atmsp {
+
+namespace {
+
+constexpr char        kMagic[4]        = {'A', 'T', 'M', 'J'};
+constexpr std::uint16_t kVersion       = 1;
+constexpr std::size_t kSegmentHeader   = 64;
+constexpr std::size_t kRecordHeader    = 16;
+constexpr std::size_t kMaxField        = 1024;   // longer strings are truncated
+constexpr std::size_t kMaxRecord       = 4096;
+constexpr std::uint16_t kFlagPanMasked = 0x0001;
+
+constexpr std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+// ---- encoding -------------------------------------------------------------
+
+class Writer {
+public:
+    Writer(char* p, std::size_t cap) : p_(p), cap_(cap) {}
+
+    template <class T> void put(T v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (n_ + sizeof(T) > cap_) { ok_ = false; return; }
+        std::memcpy(p_ + n_, &v, sizeof(T));
+        n_ += sizeof(T);
+    }
+    void str(std::string_view s) {
+        if (s.size() > kMaxField) s = s.substr(0, kMaxField);
+        put(static_cast<std::uint16_t>(s.size()));
+        if (n_ + s.size() > cap_) { ok_ = false; return; }
+        std::memcpy(p_ + n_, s.data(), s.size());
+        n_ += s.size();
+    }
+    std::size_t size() const { return n_; }
+    bool ok() const { return ok_; }
+
+private:
+    char* p_;
+    std::size_t cap_;
+    std::size_t n_{0};
+    bool ok_{true};
+};
+
+class Reader {
+public:
+    Reader(const char* p, std::size_t n) : p_(p), n_(n) {}
+
+    template <class T> T get() {
+        T v{};
+        if (pos_ + sizeof(T) > n_) { ok_ = false; return v; }
+        std::memcpy(&v, p_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+    std::string str() {
+        auto len = get<std::uint16_t>();
+        if (!ok_ || pos_ + len > n_) { ok_ = false; return {}; }
+        std::string s(p_ + pos_, len);
+        pos_ += len;
+        return s;
+    }
+    bool ok() const { return ok_; }
+
+private:
+    const char* p_;
+    std::size_t n_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+// Encodes e into buf (header + body, 8-byte padded). Returns 0 if it does not fit.
+std::size_t encode(const Event& e, char* buf, std::size_t cap) {
+    Writer w(buf + kRecordHeader, cap - kRecordHeader);
+    std::uint16_t type = 0, flags = 0;
+    std::int64_t ts = 0;
+
+    std::visit([&](auto&& ev) {
+        using E = std::decay_t<decltype(ev)>;
+        ts = ev.ts.wall_ns();
+        if constexpr (std::is_same_v<E, ErrorEvent>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::Error);
+            w.put<std::int32_t>(ev.code);
+            w.str(ev.message);
+        } else if constexpr (std::is_same_v<E, CardInserted>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::CardInserted);
+        } else if constexpr (std::is_same_v<E, CardRemoved>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::CardRemoved);
+        } else if constexpr (std::is_same_v<E, Track2Read>) {
+            // Never persist a clear PAN or raw track data.
+            type  = static_cast<std::uint16_t>(JournalRecordType::Track2Read);
+            flags = kFlagPanMasked;
+            w.str(mask_pan(ev.pan));
+            w.str(ev.exp);
+        } else if constexpr (std::is_same_v<E, ChipReady>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::ChipReady);
+            w.put<std::uint8_t>(ev.contactless ? 1 : 0);
+        } else if constexpr (std::is_same_v<E, PinRequested>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::PinRequested);
+            w.put<std::int32_t>(ev.minLen);
+            w.put<std::int32_t>(ev.maxLen);
+            w.put<std::uint8_t>(ev.bypassAllowed ? 1 : 0);
+        } else if constexpr (std::is_same_v<E, PinEntered>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::PinEntered);
+            w.str(ev.masked);
+        } else if constexpr (std::is_same_v<E, SensorChanged>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::SensorChanged);
+            w.put<std::uint8_t>(static_cast<std::uint8_t>(ev.sensor));
+            w.put<std::int32_t>(ev.value);
+        } else if constexpr (std::is_same_v<E, SessionStarted>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::SessionStarted);
+            w.str(ev.sessionId);
+        } else if constexpr (std::is_same_v<E, SessionEnded>) {
+            type = static_cast<std::uint16_t>(JournalRecordType::SessionEnded);
+            w.str(ev.sessionId);
+            w.put<std::int32_t>(ev.resultCode);
+        }
+    }, e);
+
+    if (!w.ok() || type == 0) return 0;
+    const std::size_t total = align8(kRecordHeader + w.size());
+    if (total > cap) return 0;
+    std::memset(buf + kRecordHeader + w.size(), 0, total - kRecordHeader - w.size());
+
+    const auto size32 = static_cast<std::uint32_t>(total);
+    std::memcpy(buf + 0, &size32, 4);
+    std::memcpy(buf + 4, &type, 2);
+    std::memcpy(buf + 6, &flags, 2);
+    std::memcpy(buf + 8, &ts, 8);
+    return total;
+}
+
+template <class E> E stamped(std::int64_t ts) {
+    E ev;
+    ev.ts = Timestamp::from_wall_ns(ts);
+    return ev;
+}
+
+std::optional<Event> decode(std::uint16_t type, std::int64_t ts, const char* body, std::size_t n) {
+    Reader r(body, n);
+    std::optional<Event> out;
+    switch (static_cast<JournalRecordType>(type)) {
+        case JournalRecordType::Error: {
+            auto ev = stamped<ErrorEvent>(ts);
+            ev.code = r.get<std::int32_t>();
+            ev.message = r.str();
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::CardInserted: out = stamped<CardInserted>(ts); break;
+        case JournalRecordType::CardRemoved:  out = stamped<CardRemoved>(ts);  break;
+        case JournalRecordType::Track2Read: {
+            auto ev = stamped<Track2Read>(ts);
+            ev.pan = r.str();
+            ev.exp = r.str();
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::ChipReady: {
+            auto ev = stamped<ChipReady>(ts);
+            ev.contactless = r.get<std::uint8_t>() != 0;
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::PinRequested: {
+            auto ev = stamped<PinRequested>(ts);
+            ev.minLen = r.get<std::int32_t>();
+            ev.maxLen = r.get<std::int32_t>();
+            ev.bypassAllowed = r.get<std::uint8_t>() != 0;
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::PinEntered: {
+            auto ev = stamped<PinEntered>(ts);
+            ev.masked = r.str();
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::SensorChanged: {
+            auto ev = stamped<SensorChanged>(ts);
+            ev.sensor = static_cast<SensorKind>(r.get<std::uint8_t>());
+            ev.value = r.get<std::int32_t>();
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::SessionStarted: {
+            auto ev = stamped<SessionStarted>(ts);
+            ev.sessionId = r.str();
+            out = std::move(ev);
+            break;
+        }
+        case JournalRecordType::SessionEnded: {
+            auto ev = stamped<SessionEnded>(ts);
+            ev.sessionId = r.str();
+            ev.resultCode = r.get<std::int32_t>();
+            out = std::move(ev);
+            break;
+        }
+        default:
+            return std::nullopt;
+    }
+    if (!r.ok()) return std::nullopt;
+    return out;
+}
+
+std::string segment_name(std::uint64_t seq) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "journal-%08llu.atj", static_cast<unsigned long long>(seq));
+    return buf;
+}
+
+std::uint64_t segment_seq(const std::string& path) {
+    const auto stem = fs::path(path).stem().string();   // journal-00000001
+    try { return std::stoull(stem.substr(std::string("journal-").size())); }
+    catch (...) { return 0; }
+}
+
+} // namespace
+
+// ---- mapped segment ---------------------------------------------------------
+
+namespace detail {
+
+class MappedSegment {
+public:
+    static std::shared_ptr<MappedSegment> create(const std::string& path,
+                                                 std::uint64_t seq, std::size_t capacity) {
+        auto s = std::shared_ptr<MappedSegment>(new MappedSegment(path, capacity));
+        if (!s->map()) return nullptr;
+        s->prefault();
+
+        char hdr[kSegmentHeader] = {};
+        const std::uint16_t hsize = kSegmentHeader;
+        const std::int64_t created = TimeSource::now().wall_ns();
+        std::memcpy(hdr + 0, kMagic, 4);
+        std::memcpy(hdr + 4, &kVersion, 2);
+        std::memcpy(hdr + 6, &hsize, 2);
+        std::memcpy(hdr + 8, &seq, 8);
+        std::memcpy(hdr + 16, &created, 8);
+        std::memcpy(s->data_, hdr, kSegmentHeader);
+        s->used_.store(kSegmentHeader, std::memory_order_release);
+        return s;
+    }
+
+    ~MappedSegment() { finish(); }
+
+    std::size_t remaining() const { return capacity_ - used_.load(std::memory_order_relaxed); }
+
+    // Caller holds the journal lock; only one writer at a time.
+    void write(const char* rec, std::size_t n) {
+        const std::size_t off = used_.load(std::memory_order_relaxed);
+        char* dst = data_ + off;
+        // Body first, size last: a reader never sees a half-written record.
+        std::memcpy(dst + 4, rec + 4, n - 4);
+        std::uint32_t size32;
+        std::memcpy(&size32, rec, 4);
+        std::atomic_ref<std::uint32_t>(*reinterpret_cast<std::uint32_t*>(dst))
+            .store(size32, std::memory_order_release);
+        used_.store(off + n, std::memory_order_release);
+    }
+
+    // Pushes everything written since the last sync to stable storage.
+    bool sync() {
+        const std::size_t used = used_.load(std::memory_order_acquire);
+        if (!data_ || used <= synced_) return false;
+#ifdef _WIN32
+        FlushViewOfFile(data_ + synced_, used - synced_);
+        FlushFileBuffers(file_);
+#else
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t from = synced_ & ~(page - 1);
+        ::msync(data_ + from, used - from, MS_SYNC);
+#endif
+        synced_ = used;
+        return true;
+    }
+
+    // Syncs, unmaps and truncates the file to the bytes actually used.
+    void finish() {
+        if (!data_) return;
+        sync();
+        const std::size_t used = used_.load(std::memory_order_acquire);
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        LARGE_INTEGER li; li.QuadPart = static_cast<LONGLONG>(used);
+        SetFilePointerEx(file_, li, nullptr, FILE_BEGIN);
+        SetEndOfFile(file_);
+        CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        ::munmap(data_, capacity_);
+        if (::ftruncate(fd_, static_cast<off_t>(used)) == 0) ::fsync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+    }
+
+    // Finishes and deletes the file (used for an untouched spare segment).
+    void discard() {
+        finish();
+        std::error_code ec;
+        fs::remove(path_, ec);
+    }
+
+    bool empty() const { return used_.load(std::memory_order_acquire) <= kSegmentHeader; }
+
+private:
+    // Write-touches every page so publishers never take a first-touch fault
+    // in the fresh mapping. Runs on the committer (or in start()).
+    void prefault() {
+        static const std::size_t page = page_size();
+        for (std::size_t off = 0; off < capacity_; off += page)
+            reinterpret_cast<volatile char*>(data_)[off] = 0;
+    }
+
+    static std::size_t page_size() {
+#ifdef _WIN32
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        return si.dwPageSize;
+#else
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    MappedSegment(std::string path, std::size_t capacity)
+        : path_(std::move(path)), capacity_(capacity) {}
+
+    bool map() {
+#ifdef _WIN32
+        file_ = CreateFileA(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                            nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz; sz.QuadPart = static_cast<LONGLONG>(capacity_);
+        // Creating the mapping with an explicit size extends the file.
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(sz.HighPart), sz.LowPart, nullptr);
+        if (!mapping_) { CloseHandle(file_); file_ = INVALID_HANDLE_VALUE; return false; }
+        data_ = static_cast<char*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, capacity_));
+        if (!data_) {
+            CloseHandle(mapping_); CloseHandle(file_);
+            mapping_ = nullptr; file_ = INVALID_HANDLE_VALUE;
+            return false;
+        }
+#else
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+        if (fd_ < 0) return false;
+        int rc;
+#  ifdef __linux__
+        rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(capacity_));   // real blocks, not a sparse file
+#  else
+        rc = ::ftruncate(fd_, static_cast<off_t>(capacity_));
+#  endif
+        if (rc != 0) { ::close(fd_); fd_ = -1; return false; }
+        int flags = MAP_SHARED;
+#  ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;     // read the pages in now; prefault() then dirties them
+#  endif
+        void* p = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, flags, fd_, 0);
+        if (p == MAP_FAILED) { ::close(fd_); fd_ = -1; return false; }
+        data_ = static_cast<char*>(p);
+#endif
+        return true;
+    }
+
+    std::string path_;
+    std::size_t capacity_;
+    char* data_{nullptr};
+    std::atomic<std::size_t> used_{0};
+    std::size_t synced_{0};        // touched only under EventJournal::commit_mu_
+#ifdef _WIN32
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
+
+} // namespace detail
+
+// ---- EventJournal ------------------------------------------------------------
+
+EventJournal::EventJournal(JournalOptions opts) : opts_(std::move(opts)) {
+    opts_.segmentBytes = std::max(opts_.segmentBytes, kSegmentHeader + kMaxRecord);
+    opts_.fsyncMs = std::max(opts_.fsyncMs, 1);
+}
+
+EventJournal::~EventJournal() {
+    detach();
+    stop();
+}
+
+bool EventJournal::start() {
+    if (running_) return true;
+    std::error_code ec;
+    fs::create_directories(opts_.dir, ec);
+
+    std::uint64_t last = 0;
+    for (const auto& f : list_journal_segments(opts_.dir)) last = std::max(last, segment_seq(f));
+    next_seq_ = last + 1;   // never append to a segment from a previous run
+
+    auto seg = open_segment(next_seq_++);
+    if (!seg) {
+        spdlog::error("[Journal] cannot create segment in '{}'", opts_.dir);
+        return false;
+    }
+    auto spare = open_segment(next_seq_++);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        current_ = std::move(seg);
+        spare_ = std::move(spare);
+    }
+    stop_ = false;
+    running_ = true;
+    committer_ = std::thread([this]{ commit_loop(); });
+    spdlog::info("[Journal] writing to '{}' (segment={} KiB, fsync={} ms)",
+                 opts_.dir, opts_.segmentBytes / 1024, opts_.fsyncMs);
+    return true;
+}
+
+void EventJournal::stop() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lk(cv_mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (committer_.joinable()) committer_.join();
+    running_ = false;
+
+    commit();
+    std::shared_ptr<detail::MappedSegment> cur, spare;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        cur = std::move(current_);
+        spare = std::move(spare_);
+    }
+    if (cur) cur->finish();
+    if (spare) spare->discard();
+    spdlog::info("[Journal] stopped ({} records, {} bytes, {} dropped)",
+                 records_.load(), bytes_.load(), dropped_.load());
+}
+
+void EventJournal::attach(EventBus& bus) {
+    detach();
+    bus_ = &bus;
+    sub_ = bus.subscribe([this](const Event& e){ append(e); });
+}
+
+void EventJournal::detach() {
+    if (!bus_) return;
+    bus_->unsubscribe(sub_);
+    bus_ = nullptr;
+    sub_ = 0;
+}
+
+void EventJournal::append(const Event& e) {
+    char rec[kMaxRecord];
+    const std::size_t n = encode(e, rec, sizeof(rec));
+    if (n == 0) { dropped_.fetch_add(1, std::memory_order_relaxed); return; }
+
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!current_) { dropped_.fetch_add(1, std::memory_order_relaxed); return; }
+    // Keep room for the zero terminator the reader stops at.
+    if (current_->remaining() < n + kRecordHeader && !rotate_locked()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    current_->write(rec, n);
+    lk.unlock();
+
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(n, std::memory_order_relaxed);
+}
+
+void EventJournal::flush() {
+    commit();
+}
+
+JournalStats EventJournal::stats() const {
+    JournalStats s;
+    s.records  = records_.load();
+    s.bytes    = bytes_.load();
+    s.dropped  = dropped_.load();
+    s.segments = segments_.load();
+    s.syncs    = syncs_.load();
+    return s;
+}
+
+std::shared_ptr<detail::MappedSegment> EventJournal::open_segment(std::uint64_t seq) {
+    const auto path = (fs::path(opts_.dir) / segment_name(seq)).string();
+    auto seg = detail::MappedSegment::create(path, seq, opts_.segmentBytes);
+    if (seg) segments_.fetch_add(1, std::memory_order_relaxed);
+    else spdlog::warn("[Journal] failed to map segment '{}'", path);
+    return seg;
+}
+
+bool EventJournal::rotate_locked() {
+    // Either way the committer should prepare the next spare now.
+    wake_.store(true, std::memory_order_relaxed);
+    cv_.notify_one();
+    // Publishers never create segments or wait for one: a burst that fills a
+    // whole segment before the committer has replaced the spare is dropped.
+    if (!spare_) return false;
+    retired_.push_back(std::move(current_));
+    current_ = std::move(spare_);
+    return true;
+}
+
+void EventJournal::commit_loop() {
+    const auto interval = std::chrono::milliseconds(opts_.fsyncMs);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(cv_mu_);
+            cv_.wait_for(lk, interval, [&]{ return stop_ || wake_.load(std::memory_order_relaxed); });
+            if (stop_) return;
+        }
+        wake_.store(false, std::memory_order_relaxed);
+        commit();
+    }
+}
+
+void EventJournal::commit() {
+    std::lock_guard<std::mutex> commit_lk(commit_mu_);
+
+    std::shared_ptr<detail::MappedSegment> cur;
+    std::vector<std::shared_ptr<detail::MappedSegment>> retired;
+    std::uint64_t spare_seq = 0;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        cur = current_;
+        retired.swap(retired_);
+        if (running_ && !spare_ && !spare_pending_) {
+            spare_pending_ = true;
+            spare_seq = next_seq_++;
+        }
+    }
+
+    for (auto& r : retired) r->finish();
+    if (cur && cur->sync()) syncs_.fetch_add(1, std::memory_order_relaxed);
+
+    if (spare_seq != 0) {
+        auto spare = open_segment(spare_seq);
+        std::lock_guard<std::mutex> lk(mu_);
+        spare_ = std::move(spare);
+        spare_pending_ = false;
+    }
+    if (!retired.empty()) prune();
+}
+
+void EventJournal::prune() {
+    if (opts_.maxSegments <= 0) return;
+    // The live and spare segments are always the newest two; never touch them.
+    const std::size_t keep = static_cast<std::size_t>(std::max(opts_.maxSegments, 2));
+    auto files = list_journal_segments(opts_.dir);
+    if (files.size() <= keep) return;
+    for (std::size_t i = 0; i < files.size() - keep; ++i) {
+        std::error_code ec;
+        fs::remove(files[i], ec);
+    }
+}
+
+// ---- reading -------------------------------------------------------------------
+
+std::vector<std::string> list_journal_segments(const std::string& dir) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (const auto& de : fs::directory_iterator(dir, ec)) {
+        if (!de.is_regular_file()) continue;
+        const auto name = de.path().filename().string();
+        if (name.rfind("journal-", 0) == 0 && de.path().extension() == ".atj")
+            out.push_back(de.path().string());
+    }
+    std::sort(out.begin(), out.end(), [](const std::string& a, const std::string& b){
+        return segment_seq(a) < segment_seq(b);
+    });
+    return out;
+}
+
+JournalReader::JournalReader(const std::string& dir) : files_(list_journal_segments(dir)) {}
+
+bool JournalReader::load_next_segment() {
+    while (file_idx_ < files_.size()) {
+        std::ifstream f(files_[file_idx_++], std::ios::binary);
+        if (!f) continue;
+        buf_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        if (buf_.size() < kSegmentHeader || std::memcmp(buf_.data(), kMagic, 4) != 0) {
+            spdlog::warn("[Journal] skipping '{}': not a journal segment", files_[file_idx_ - 1]);
+            continue;
+        }
+        std::uint16_t hsize = 0;
+        std::memcpy(&hsize, buf_.data() + 6, 2);
+        pos_ = std::max<std::size_t>(hsize, kSegmentHeader);
+        return true;
+    }
+    buf_.clear();
+    pos_ = 0;
+    return false;
+}
+
+std::optional<JournalRecord> JournalReader::next() {
+    for (;;) {
+        if (pos_ + kRecordHeader > buf_.size()) {
+            if (!load_next_segment()) return std::nullopt;
+            continue;
+        }
+        std::uint32_t size = 0;
+        std::uint16_t type = 0, flags = 0;
+        std::int64_t ts = 0;
+        const char* p = buf_.data() + pos_;
+        std::memcpy(&size, p + 0, 4);
+        std::memcpy(&type, p + 4, 2);
+        std::memcpy(&flags, p + 6, 2);
+        std::memcpy(&ts, p + 8, 8);
+
+        // size==0 is the end-of-segment marker; anything malformed ends it too.
+        if (size < kRecordHeader || pos_ + size > buf_.size()) {
+            pos_ = buf_.size();
+            continue;
+        }
+        pos_ += size;
+
+        auto ev = decode(type, ts, p + kRecordHeader, size - kRecordHeader);
+        if (!ev) continue;   // unknown record type from a newer writer
+        JournalRecord rec;
+        rec.tsNs = ts;
+        rec.panMasked = (flags & kFlagPanMasked) != 0;
+        rec.event = std::move(*ev);
+        return rec;
+    }
+}
+
+} // namespace atmsp
@@ -5,36 +5,25 @@
 #include <chrono>
 #include <ctime>
 #include <algorithm>            // std::clamp
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include <nlohmann/json.hpp>
 
 #include "atmsp/logging.h"
 #include "atmsp/event_bus.h"
 #include "atmsp/session.h"
 #include "atmsp/events.h"
-#include "atmsp/card_reader_sp.h"
-#include "atmsp/pin_pad_sp.h"
 #include "atmsp/config.h"
+#include "atmsp/command_queue.h"
+#include "atmsp/device_registry.h"
+#include "atmsp/journal.h"
+#include "atmsp/printer_sp.h"
+#include "atmsp/redact.h"
+#include "atmsp/time_source.h"
 
 using namespace std::chrono_literals;
 
-namespace atmsp {
-    std::unique_ptr<ICardReaderSP> make_mock_card_reader();
-    std::unique_ptr<IPinPadSP>    make_mock_pin_pad();
-}
-
-static std::string tp_to_string(const atmsp::TimePoint& tp) {
-    auto tt = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    char buf[64];
-    std::strftime(buf, sizeof(buf), "%F %T", &tm);
-    return buf;
-}
-
 static void print_usage() {
     std::cout
       << "atmsp_demo usage:\n"
@@ -108,19 +97,23 @@ int main(int argc, char** argv) {
 
     // --- 2) Event bus & subscriber ---
     EventBus bus;
+    std::mutex receiptMu;
+    std::string receiptPan = "-";      // masked, for the end-of-session receipt
     auto subId = bus.subscribe([&](const Event& e){
         std::visit([&](auto&& ev){
             using E = std::decay_t<decltype(ev)>;
             if constexpr (std::is_same_v<E, ErrorEvent>) {
                 spdlog::error("ErrorEvent code={} msg={}", ev.code, ev.message);
             } else if constexpr (std::is_same_v<E, SessionStarted>) {
-                spdlog::info("SessionStarted id={} at {}", ev.sessionId, tp_to_string(ev.ts));
+                spdlog::info("SessionStarted id={} at {}", ev.sessionId, format_time(ev.ts).view());
             } else if constexpr (std::is_same_v<E, SessionEnded>) {
-                spdlog::info("SessionEnded id={} rc={} at {}", ev.sessionId, ev.resultCode, tp_to_string(ev.ts));
+                spdlog::info("SessionEnded id={} rc={} at {}", ev.sessionId, ev.resultCode, format_time(ev.ts).view());
             } else if constexpr (std::is_same_v<E, CardInserted>) {
-                spdlog::info("CardInserted at {}", tp_to_string(ev.ts));
+                spdlog::info("CardInserted at {}", format_time(ev.ts).view());
             } else if constexpr (std::is_same_v<E, Track2Read>) {
                 spdlog::info("Track2Read PAN={}******{}", ev.pan.substr(0,6), ev.pan.substr(ev.pan.size()-4));
+                std::lock_guard<std::mutex> lk(receiptMu);
+                receiptPan = mask_pan(ev.pan);
             } else if constexpr (std::is_same_v<E, CardRemoved>) {
                 spdlog::info("CardRemoved");
             } else if constexpr (std::is_same_v<E, PinRequested>) {
@@ -129,41 +122,98 @@ int main(int argc, char** argv) {
                 spdlog::info("PinEntered masked={}", ev.masked);
             } else if constexpr (std::is_same_v<E, ChipReady>) {
                 spdlog::info("ChipReady contactless={}", ev.contactless);
+            } else if constexpr (std::is_same_v<E, SensorChanged>) {
+                spdlog::info("SensorChanged {}={}", to_string(ev.sensor), ev.value);
             }
         }, e);
     });
 
+    // Per-device event rate limits; SPs publish through bus.source(logical).
+    if (cfg) {
+        for (const auto& [logical, dc] : cfg->devices)
+            bus.set_rate_limit(logical, dc.eventsPerSec, dc.eventBurst);
+    }
+
+    // --- 2b) Binary event journal (optional) ---
+    std::unique_ptr<EventJournal> journal;
+    if (cfg && cfg->journal.enabled) {
+        JournalOptions jo;
+        jo.dir          = cfg->journal.dir;
+        jo.segmentBytes = static_cast<std::size_t>(std::max(cfg->journal.segmentMB, 1)) * 1024 * 1024;
+        jo.fsyncMs      = cfg->journal.fsyncMs;
+        jo.maxSegments  = cfg->journal.maxSegments;
+        journal = std::make_unique<EventJournal>(jo);
+        if (journal->start()) journal->attach(bus);
+        else journal.reset();
+    }
+
     // --- 3) Start a session ---
     Session session("S-" + std::to_string(std::time(nullptr)), bus);
     session.start();
 
-    // --- 4) Create and open mock devices ---
+    // --- 4) Instantiate and open every configured device (in parallel) ---
     std::string cardLogical = "CARDREADER1";
     std::string pinLogical  = "PINPAD1";
-    if (cfg) {
-        if (!cfg->devices.count(cardLogical))
-            spdlog::warn("Device '{}' not found in config; using default.", cardLogical);
-        if (!cfg->devices.count(pinLogical))
-            spdlog::warn("Device '{}' not found in config; using default.", pinLogical);
+    AppConfig devCfg = cfg ? *cfg : AppConfig{};
+    if (!devCfg.devices.count(cardLogical)) {
+        if (cfg) spdlog::warn("Device '{}' not found in config; using default.", cardLogical);
+        devCfg.devices[cardLogical].type = "card_reader";
+    }
+    if (!devCfg.devices.count(pinLogical)) {
+        if (cfg) spdlog::warn("Device '{}' not found in config; using default.", pinLogical);
+        devCfg.devices[pinLogical].type = "pin_pad";
     }
 
-    auto card = make_mock_card_reader();
-    auto pin  = make_mock_pin_pad();
+    DeviceRegistry registry;
+    auto report = registry.bring_up(devCfg, bus);
+    log_startup_report(report);
 
-    card->init(&bus);
-    pin->init(&bus);
-    card->open(cardLogical);
-    pin->open(pinLogical);
+    auto* card = registry.get(cardLogical);
+    auto* pin  = registry.get(pinLogical);
+    if (!card || !pin) {
+        spdlog::error("Required devices '{}'/'{}' did not start; exiting.", cardLogical, pinLogical);
+        session.end(1);
+        return 1;
+    }
+
+    // Per-device command queues: setup commands go out as one pipelined batch,
+    // subject to the device's admission limits.
+    auto queue_options = [&](const std::string& logical) {
+        const auto& dc = devCfg.devices.at(logical);
+        CommandQueueOptions o;
+        o.admission = { dc.commandsPerSec, dc.commandBurst, dc.maxInFlight };
+        return o;
+    };
+    // Receipt templates are compiled once here; printing only fills fields.
+    std::string printerLogical = "PRINTER1";
+    auto* printer = registry.get_as<IPrinterSP>(printerLogical);
+    if (printer) {
+        for (const auto& [tname, file] : devCfg.devices.at(printerLogical).templates) {
+            std::ifstream in(file);
+            std::stringstream text;
+            text << in.rdbuf();
+            std::string err;
+            if (!in.is_open() || printer->load_template(tname, text.str(), &err) != SpError::Ok)
+                spdlog::warn("[{}] template '{}' ({}) not loaded: {}", printerLogical, tname, file,
+                             in.is_open() ? err : "cannot open file");
+        }
+    }
+
+    CommandQueue cardQ(*card, queue_options(cardLogical));
+    CommandQueue pinQ(*pin, queue_options(pinLogical));
 
     // --- 5) Apply CLI-driven failure injection (optional) ---
+    std::vector<DeviceCommand> cardSetup, pinSetup;
     if (failPct >= 0) {
-        (void)card->execute("SetFailureRate", {{"pct", failPct}});
+        cardSetup.push_back({"SetFailureRate", {{"pct", failPct}}});
         spdlog::warn("[CLI] SetFailureRate={}%% applied", failPct);
     }
     if (injectPinErr) {
-        (void)pin->execute("InjectPinError", {});
+        pinSetup.push_back({"InjectPinError", nlohmann::json::object()});
         spdlog::warn("[CLI] InjectPinError scheduled for next RequestPin");
     }
+    (void)cardQ.executeBatch(std::move(cardSetup), session.resource());
+    (void)pinQ.executeBatch(std::move(pinSetup), session.resource());
 
     // --- 6) Trigger a PIN entry after a short delay ---
     std::this_thread::sleep_for(5s);
@@ -178,15 +228,51 @@ int main(int argc, char** argv) {
     }
 
     nlohmann::json cmd = { {"minLen", minLen}, {"maxLen", maxLen}, {"bypass", bypass} };
-    (void)pin->execute("RequestPin", cmd);
+    (void)pinQ.submit("RequestPin", cmd, session.resource());
 
     // --- 7) Let events flow, then end the session ---
     std::this_thread::sleep_for(10s);
+
+    // Print the receipt without waiting for the device; it spools in the background.
+    if (auto t = printer ? printer->find_template("withdrawal") : nullptr) {
+        std::string pan;
+        {
+            std::lock_guard<std::mutex> lk(receiptMu);
+            pan = receiptPan;
+        }
+        const auto date = format_time(TimeSource::now());
+        std::vector<std::string_view> values(t->fields().size());
+        auto set = [&](std::string_view field, std::string_view v) {
+            if (int i = t->field_index(field); i >= 0) values[static_cast<std::size_t>(i)] = v;
+        };
+        set("terminal", "ATM-DEMO-01");
+        set("date", date.view());
+        set("session", session.id());
+        set("pan", pan);
+        set("type", "WITHDRAWAL");
+        set("amount", "100.00");
+        set("result", "APPROVED");
+        const auto ticket = printer->print(*t, values);
+        if (ticket.result == SpError::Ok) spdlog::info("[{}] receipt spooled as job {}", printerLogical, ticket.jobId);
+        else spdlog::warn("[{}] receipt not printed: {}", printerLogical, to_string(ticket.result));
+    }
     session.end(0);
 
     // --- 8) Cleanup ---
-    card->close();
-    pin->close();
+    cardQ.drain();
+    pinQ.drain();
+    if (printer && !printer->wait_idle(5000))
+        spdlog::warn("[{}] spool did not drain before shutdown", printerLogical);
+    registry.close_all();
+    for (const auto& [logical, _] : devCfg.devices) {
+        const auto& src = bus.source(logical);
+        if (src.shed.load() > 0)
+            spdlog::warn("[{}] {} event(s) shed by rate limit", logical, src.shed.load());
+    }
+    if (journal) {
+        journal->detach();
+        journal->stop();
+    }
 
     spdlog::info("ATM SP Demo finished.");
     return 0;
@@ -27,6 +27,7 @@ public:
         stop_ = false;
         opened_ = true;
         logical_ = logicalId;
+        src_ = bus_ ? &bus_->source(logical_) : nullptr;
         worker_ = std::thread([this]{ run(); });
         spdlog::info("[{}] opened logical device '{}'", name(), logical_);
         return SpError::Ok;
@@ -82,7 +83,7 @@ private:
             std::this_thread::sleep_for(std::chrono::seconds(dwell_seconds(rng)));
             if (stop_) break;
 
-            if (bus_) bus_->publish(CardInserted{});
+            if (src_) bus_->publish(*src_, CardInserted{});
             spdlog::info("[{}] CardInserted", name());
 
             // Small delay before reading tracks
@@ -100,7 +101,7 @@ private:
             if (r100(rng) <= dropChance) {
                 spdlog::warn("[{}] Simulated failure: dropped Track2Read", name());
             } else {
-                if (bus_) bus_->publish(t2);
+                if (src_) bus_->publish(*src_, t2);
                 spdlog::info("[{}] Track2Read (PAN masked: {}******{})",
                              name(), t2.pan.substr(0,6), t2.pan.substr(t2.pan.size()-4));
             }
@@ -109,12 +110,13 @@ private:
             std::this_thread::sleep_for(2s);
             if (stop_) break;
 
-            if (bus_) bus_->publish(CardRemoved{});
+            if (src_) bus_->publish(*src_, CardRemoved{});
             spdlog::info("[{}] CardRemoved", name());
         }
     }
 
     EventBus* bus_ {nullptr};
+    EventSource* src_ {nullptr};            // rate-limited publishing handle for logical_
     std::string logical_;
     std::thread worker_;
     std::atomic<bool> opened_ {false};
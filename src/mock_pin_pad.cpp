@@ -24,6 +24,7 @@ public:
     SpError open(const std::string& logicalId) override {
         if (opened_) return SpError::AlreadyOpen;
         logical_ = logicalId;
+        src_ = bus_ ? &bus_->source(logical_) : nullptr;
         opened_ = true;
         spdlog::info("[{}] opened logical device '{}'", name(), logical_);
         return SpError::Ok;
@@ -47,12 +48,12 @@ public:
         // ---- Normal commands ----
         if (command == "RequestPin") {
             // Publish a request event (so UI/upper layer can show prompt)
-            if (bus_) {
+            if (src_) {
                 PinRequested req;
                 req.minLen        = payload.value("minLen", 4);
                 req.maxLen        = payload.value("maxLen", 12);
                 req.bypassAllowed = payload.value("bypass", false);
-                bus_->publish(req);
+                bus_->publish(*src_, req);
             }
 
             // If an error was injected, fail this request immediately
@@ -67,7 +68,7 @@ public:
             auto fut = pr->get_future();
             std::thread([this, pr]() {
                 std::this_thread::sleep_for(1500ms);
-                if (bus_) bus_->publish(PinEntered{ .masked = "****" });
+                if (src_) bus_->publish(*src_, PinEntered{ .masked = "****" });
                 pr->set_value(nlohmann::json{{"ok", true}, {"masked", "****"}});
             }).detach();
             return fut;
@@ -83,6 +84,7 @@ public:
 
 private:
     EventBus* bus_ {nullptr};
+    EventSource* src_ {nullptr};            // rate-limited publishing handle for logical_
     std::string logical_;
     std::atomic<bool> opened_ {false};
     std::atomic<bool> next_pin_error_{false};
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "atmsp/printer_sp.h"
+#include "atmsp/logging.h"
+#include "mock_util.h"
+
+namespace atmsp {
+
+namespace {
+
+using mock::ready;
+
+// Per-thread render buffer. It is swapped into the spool slot on enqueue and
+// gets back the slot's old buffer, so steady-state printing does not allocate.
+std::string& render_buffer() {
+    thread_local std::string buf;
+    buf.clear();
+    return buf;
+}
+
+} // namespace
+
+// Receipt printer with a bounded in-memory spool. print()/execute("Print")
+// render on the caller's thread and return as soon as the receipt is queued;
+// a worker thread feeds the (simulated, slow) device one receipt at a time.
+class MockPrinter final : public IPrinterSP {
+public:
+    explicit MockPrinter(PrinterOptions opts)
+        : opts_(opts), ring_(std::max<std::size_t>(opts.spoolCapacity, 1)) {}
+
+    std::string name() const override { return "MockPrinter"; }
+
+    SpError init(EventBus* bus) override {
+        return bus ? SpError::Ok : SpError::NotInitialized;
+    }
+
+    SpError open(const std::string& logicalId) override {
+        if (opened_) return SpError::AlreadyOpen;
+        logical_ = logicalId;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = false;
+        }
+        opened_ = true;
+        worker_ = std::thread([this]{ run(); });
+        spdlog::info("[{}] opened logical device '{}'", name(), logical_);
+        return SpError::Ok;
+    }
+
+    void close() override {
+        if (!opened_.exchange(false)) return;
+        std::size_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+            dropped = count_;
+            count_ = 0;
+        }
+        cv_.notify_all();
+        stop_cv_.notify_all();
+        if (worker_.joinable()) worker_.join();
+        if (dropped) spdlog::warn("[{}] {} spooled receipt(s) discarded on close", name(), dropped);
+        spdlog::info("[{}] closed", name());
+    }
+
+    SpError load_template(const std::string& name, std::string_view text, std::string* error) override {
+        auto t = ReceiptTemplate::compile(text, error);
+        if (!t) return SpError::InvalidCommand;
+        auto compiled = std::make_shared<const ReceiptTemplate>(std::move(*t));
+        std::lock_guard<std::mutex> lk(templates_mu_);
+        templates_[name] = std::move(compiled);
+        return SpError::Ok;
+    }
+
+    std::shared_ptr<const ReceiptTemplate> find_template(const std::string& name) const override {
+        std::lock_guard<std::mutex> lk(templates_mu_);
+        auto it = templates_.find(name);
+        return it == templates_.end() ? nullptr : it->second;
+    }
+
+    PrintTicket print(const ReceiptTemplate& t, std::span<const std::string_view> values) override {
+        auto& buf = render_buffer();
+        t.render(values, buf);
+        return enqueue(buf);
+    }
+
+    std::future<nlohmann::json> execute(const std::string& command,
+                                        const nlohmann::json& payload) override {
+        if (command == "Print") {
+            auto t = find_template(payload.value("template", ""));
+            if (!t) return ready({{"ok", false}, {"error", "UnknownTemplate"}});
+            auto& buf = render_buffer();
+            t->render_json(payload.contains("fields") ? payload["fields"] : nlohmann::json::object(), buf);
+            const auto ticket = enqueue(buf);
+            if (ticket.result != SpError::Ok)
+                return ready({{"ok", false}, {"error", to_string(ticket.result)}});
+            return ready({{"ok", true}, {"jobId", ticket.jobId}});
+        }
+        if (command == "LoadTemplate") {
+            std::string err;
+            const auto rc = load_template(payload.value("name", ""), payload.value("text", ""), &err);
+            if (rc != SpError::Ok) return ready({{"ok", false}, {"error", "InvalidData"}, {"detail", err}});
+            return ready({{"ok", true}});
+        }
+        if (command == "GetStatus") {
+            const auto s = stats();
+            return ready({{"ok", true}, {"submitted", s.submitted}, {"printed", s.printed},
+                          {"rejected", s.rejected}, {"queued", s.queued}, {"peakQueued", s.peakQueued}});
+        }
+        return ready({{"ok", false}, {"error", "UnknownCommand"}, {"command", command}});
+    }
+
+    bool wait_idle(int timeoutMs) override {
+        std::unique_lock<std::mutex> lk(mu_);
+        return idle_cv_.wait_for(lk, std::chrono::milliseconds(timeoutMs),
+                                 [&]{ return count_ == 0 && !printing_; });
+    }
+
+    PrinterStats stats() const override {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto s = stats_;
+        s.queued = count_;
+        return s;
+    }
+
+    ~MockPrinter() override { close(); }
+
+private:
+    struct Job {
+        std::uint64_t id{0};
+        std::string text;
+    };
+
+    // Moves the rendered receipt into the spool; text receives a spare buffer.
+    PrintTicket enqueue(std::string& text) {
+        PrintTicket t;
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            if (!opened_) { t.result = SpError::NotOpen; return t; }
+            if (count_ == ring_.size()) {
+                ++stats_.rejected;
+                t.result = SpError::Busy;
+                return t;
+            }
+            auto& slot = ring_[(head_ + count_) % ring_.size()];
+            slot.id = t.jobId = ++next_id_;
+            slot.text.swap(text);
+            ++count_;
+            ++stats_.submitted;
+            stats_.peakQueued = std::max(stats_.peakQueued, count_);
+            // A busy worker picks the job up when the current receipt is done.
+            wake = !printing_;
+        }
+        if (wake) cv_.notify_one();
+        return t;
+    }
+
+    void run() {
+        std::string receipt;
+        std::unique_lock<std::mutex> lk(mu_);
+        while (true) {
+            cv_.wait(lk, [&]{ return stop_ || count_ > 0; });
+            if (stop_) break;
+            auto& slot = ring_[head_];
+            const auto id = slot.id;
+            receipt.swap(slot.text);
+            head_ = (head_ + 1) % ring_.size();
+            --count_;
+            printing_ = true;
+
+            // Simulated device: line feed per line, then cut and present.
+            const auto lines = std::count(receipt.begin(), receipt.end(), '\n');
+            const auto busyFor = std::chrono::milliseconds(lines * opts_.msPerLine + opts_.cutMs);
+            // Waits on its own cv so print() calls never wake the busy worker.
+            if (stop_cv_.wait_for(lk, busyFor, [&]{ return stop_; })) break;
+
+            printing_ = false;
+            ++stats_.printed;
+            spdlog::debug("[{}] job {} printed ({} lines)", name(), id, lines);
+            if (count_ == 0) idle_cv_.notify_all();
+        }
+        printing_ = false;
+        idle_cv_.notify_all();
+    }
+
+    PrinterOptions opts_;
+    std::string logical_;
+    std::atomic<bool> opened_ {false};
+
+    mutable std::mutex templates_mu_;
+    std::unordered_map<std::string, std::shared_ptr<const ReceiptTemplate>> templates_;
+
+    mutable std::mutex mu_;               // guards the spool, stats_ and flags below
+    std::condition_variable cv_;          // new job while idle
+    std::condition_variable stop_cv_;     // close() while printing
+    std::condition_variable idle_cv_;
+    std::vector<Job> ring_;
+    std::size_t head_{0};
+    std::size_t count_{0};
+    std::uint64_t next_id_{0};
+    PrinterStats stats_;
+    bool printing_{false};
+    bool stop_{false};
+    std::thread worker_;
+};
+
+// Factories
+std::unique_ptr<IPrinterSP> make_mock_printer(PrinterOptions opts) {
+    return std::make_unique<MockPrinter>(opts);
+}
+
+std::unique_ptr<IPrinterSP> make_mock_printer() {
+    return make_mock_printer(PrinterOptions{});
+}
+
+} // namespace atmsp
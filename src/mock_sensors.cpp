@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+#include "atmsp/sensors_sp.h"
+#include "atmsp/events.h"
+#include "atmsp/logging.h"
+#include "atmsp/time_source.h"
+#include "mock_util.h"
+
+namespace atmsp {
+
+namespace {
+
+using mock::ready;
+
+int sensor_index(const std::string& name) {
+    for (std::size_t i = 0; i < SensorSnapshot::kCount; ++i)
+        if (to_string(static_cast<SensorKind>(i)) == name) return static_cast<int>(i);
+    return -1;
+}
+
+// Door toggles every 3 s and bounces for ~5 ms; proximity flips every 7 s and
+// chatters on ~2% of reads; temperature wanders around 21.0 C with +-0.2 noise.
+class NoisySensorBackend final : public ISensorBackend {
+public:
+    explicit NoisySensorBackend(std::uint32_t seed) : rng_(seed) {}
+
+    void read(SensorSnapshot& out, std::int64_t nowNs) override {
+        constexpr std::int64_t kMs = 1'000'000;
+        const std::int64_t t = nowNs - (t0_ ? t0_ : (t0_ = nowNs));
+
+        const std::int64_t doorPhase = t % (3000 * kMs);
+        const bool door = (t / (3000 * kMs)) % 2 == 1;
+        out.digital[0] = doorPhase < 5 * kMs ? coin_(rng_) : door;
+
+        out.digital[1] = false;   // tamper
+
+        const bool prox = (t / (7000 * kMs)) % 2 == 1;
+        out.digital[2] = chatter_(rng_) ? !prox : prox;
+
+        const double drift = 10.0 * std::sin(static_cast<double>(t) / (60'000.0 * kMs));
+        out.analog[0] = static_cast<std::int16_t>(std::lround(210.0 + drift + noise_(rng_)));
+    }
+
+private:
+    std::mt19937 rng_;
+    std::bernoulli_distribution coin_{0.5};
+    std::bernoulli_distribution chatter_{0.02};
+    std::normal_distribution<double> noise_{0.0, 1.0};
+    std::int64_t t0_{0};
+};
+
+} // namespace
+
+// Scans the backend on its own thread and publishes SensorChanged only for
+// sensors whose debounced state changed.
+class MockSensors final : public ISensorsSP {
+public:
+    MockSensors(std::unique_ptr<ISensorBackend> backend, SensorOptions opts)
+        : backend_(std::move(backend)), filter_(opts), poll_us_(opts.minPollUs) {}
+
+    std::string name() const override { return "MockSensors"; }
+
+    SpError init(EventBus* bus) override {
+        bus_ = bus;
+        return bus_ ? SpError::Ok : SpError::NotInitialized;
+    }
+
+    SpError open(const std::string& logicalId) override {
+        if (opened_) return SpError::AlreadyOpen;
+        logical_ = logicalId;
+        src_ = bus_ ? &bus_->source(logical_) : nullptr;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            SensorSnapshot initial;
+            backend_->read(initial, TimeSource::now_ns());
+            filter_.reset(initial);
+            stop_ = false;
+        }
+        opened_ = true;
+        worker_ = std::thread([this]{ run(); });
+        spdlog::info("[{}] opened logical device '{}'", name(), logical_);
+        return SpError::Ok;
+    }
+
+    void close() override {
+        if (!opened_.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) worker_.join();
+        spdlog::info("[{}] closed", name());
+    }
+
+    std::future<nlohmann::json> execute(const std::string& command,
+                                        const nlohmann::json& payload) override {
+        if (command == "GetStatus") {
+            std::lock_guard<std::mutex> lk(mu_);
+            nlohmann::json j = {{"ok", true}};
+            for (std::size_t i = 0; i < SensorSnapshot::kCount; ++i)
+                j[std::string(to_string(static_cast<SensorKind>(i)))] = filter_.stable().value(i);
+            return ready(std::move(j));
+        }
+        if (command == "GetStats") {
+            const auto s = stats();
+            return ready({{"ok", true}, {"scans", s.scans}, {"rawTransitions", s.rawTransitions},
+                          {"published", s.published}, {"pollUs", s.pollUs}});
+        }
+        if (command == "SetDebounce") {
+            const int ms = payload.value("ms", -1);
+            const std::string sensor = payload.value("sensor", "");
+            const int idx = sensor.empty() ? -1 : sensor_index(sensor);
+            if (ms < 0 || (!sensor.empty() && idx < 0))
+                return ready({{"ok", false}, {"error", "InvalidData"}});
+            std::lock_guard<std::mutex> lk(mu_);
+            auto& d = filter_.options().debounceMs;
+            if (idx >= 0) d[static_cast<std::size_t>(idx)] = ms;
+            else d.fill(ms);
+            return ready({{"ok", true}});
+        }
+        if (command == "SetPollInterval") {
+            std::lock_guard<std::mutex> lk(mu_);
+            auto& o = filter_.options();
+            const int minUs = payload.value("minUs", o.minPollUs);
+            const int maxUs = payload.value("maxUs", o.maxPollUs);
+            if (minUs <= 0 || maxUs < minUs)
+                return ready({{"ok", false}, {"error", "InvalidData"}});
+            o.minPollUs = minUs;
+            o.maxPollUs = maxUs;
+            poll_us_ = minUs;
+            cv_.notify_all();
+            return ready({{"ok", true}});
+        }
+        return ready({{"ok", false}, {"error", "UnknownCommand"}, {"command", command}});
+    }
+
+    SensorStats stats() const override {
+        std::lock_guard<std::mutex> lk(mu_);
+        SensorStats s;
+        s.scans = scans_;
+        s.rawTransitions = filter_.raw_transitions();
+        s.published = published_;
+        s.pollUs = poll_us_;
+        return s;
+    }
+
+    ~MockSensors() override { close(); }
+
+private:
+    void run() {
+        SensorSnapshot raw;
+        std::array<SensorChanged, SensorSnapshot::kCount> changed;
+        std::unique_lock<std::mutex> lk(mu_);
+        auto next = std::chrono::steady_clock::now();
+        while (!stop_) {
+            // Fixed-rate deadlines so wake-up latency does not stretch the period.
+            next += std::chrono::microseconds(poll_us_);
+            const auto now0 = std::chrono::steady_clock::now();
+            if (next < now0) next = now0;
+            cv_.wait_until(lk, next, [&]{ return stop_; });
+            if (stop_) break;
+
+            const auto now = TimeSource::now_ns();
+            backend_->read(raw, now);
+            std::size_t n = 0;
+            const bool active = filter_.update(raw, now, [&](SensorKind k, int v) {
+                changed[n].sensor = k;
+                changed[n].value = v;
+                changed[n].ts = Timestamp{ now };
+                ++n;
+            });
+            ++scans_;
+            published_ += n;
+            const auto& o = filter_.options();
+            poll_us_ = active ? o.minPollUs : std::min<std::int64_t>(poll_us_ * 2, o.maxPollUs);
+
+            if (n && src_) {
+                lk.unlock();   // subscribers must not run under our lock
+                for (std::size_t i = 0; i < n; ++i) bus_->publish(*src_, changed[i]);
+                lk.lock();
+            }
+        }
+    }
+
+    EventBus* bus_ {nullptr};
+    EventSource* src_ {nullptr};
+    std::string logical_;
+    std::unique_ptr<ISensorBackend> backend_;
+    std::atomic<bool> opened_ {false};
+
+    mutable std::mutex mu_;               // guards filter_, counters and stop_
+    std::condition_variable cv_;
+    SensorFilter filter_;
+    std::int64_t poll_us_;
+    std::uint64_t scans_{0};
+    std::uint64_t published_{0};
+    bool stop_{false};
+    std::thread worker_;
+};
+
+std::unique_ptr<ISensorBackend> make_noisy_sensor_backend(std::uint32_t seed) {
+    return std::make_unique<NoisySensorBackend>(seed);
+}
+
+// Factories
+std::unique_ptr<ISensorsSP> make_mock_sensors(std::unique_ptr<ISensorBackend> backend, SensorOptions opts) {
+    return std::make_unique<MockSensors>(std::move(backend), opts);
+}
+
+std::unique_ptr<ISensorsSP> make_mock_sensors() {
+    return make_mock_sensors(make_noisy_sensor_backend(), SensorOptions{});
+}
+
+} // namespace atmsp
@@ -0,0 +1,16 @@
+#pragma once
+#include <future>
+#include <nlohmann/json.hpp>
+
+// Helpers shared by the mock SP implementations (not part of the public API).
+
+namespace atmsp::mock {
+
+// Already-completed reply, for commands a mock answers synchronously.
+inline std::future<nlohmann::json> ready(nlohmann::json j) {
+    std::promise<nlohmann::json> p;
+    p.set_value(std::move(j));
+    return p.get_future();
+}
+
+} // namespace atmsp::mock
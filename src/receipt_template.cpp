@@ -0,0 +1,118 @@
+#include "atmsp/receipt_template.h"
+#include <algorithm>
+#include <charconv>
+
+namespace atmsp {
+
+namespace {
+
+void fail(std::string* error, std::string msg) {
+    if (error) *error = std::move(msg);
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+    while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+    return s;
+}
+
+} // namespace
+
+std::optional<ReceiptTemplate> ReceiptTemplate::compile(std::string_view text, std::string* error) {
+    ReceiptTemplate t;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const auto open = text.find("{{", pos);
+        const auto litEnd = open == std::string_view::npos ? text.size() : open;
+        if (litEnd > pos) {
+            Segment s;
+            s.offset = static_cast<std::uint32_t>(t.literals_.size());
+            s.length = static_cast<std::uint32_t>(litEnd - pos);
+            t.literals_.append(text.substr(pos, litEnd - pos));
+            // Adjacent literals collapse into one append.
+            if (!t.segments_.empty() && t.segments_.back().field < 0) t.segments_.back().length += s.length;
+            else t.segments_.push_back(s);
+        }
+        if (open == std::string_view::npos) break;
+
+        const auto close = text.find("}}", open + 2);
+        if (close == std::string_view::npos) {
+            fail(error, "unterminated '{{' at offset " + std::to_string(open));
+            return std::nullopt;
+        }
+        auto spec = trim(text.substr(open + 2, close - open - 2));
+        Segment s;
+        if (const auto colon = spec.find(':'); colon != std::string_view::npos) {
+            auto fmt = trim(spec.substr(colon + 1));
+            spec = trim(spec.substr(0, colon));
+            if (fmt.empty() || (fmt.front() != '<' && fmt.front() != '>')) {
+                fail(error, "bad format for '" + std::string(spec) + "' (use :<N or :>N)");
+                return std::nullopt;
+            }
+            s.right = fmt.front() == '>';
+            fmt.remove_prefix(1);
+            unsigned w = 0;
+            const auto [p, ec] = std::from_chars(fmt.data(), fmt.data() + fmt.size(), w);
+            if (ec != std::errc{} || p != fmt.data() + fmt.size() || w > 255) {
+                fail(error, "bad width for '" + std::string(spec) + "'");
+                return std::nullopt;
+            }
+            s.width = static_cast<std::uint16_t>(w);
+        }
+        if (spec.empty()) {
+            fail(error, "empty placeholder at offset " + std::to_string(open));
+            return std::nullopt;
+        }
+        s.field = t.field_index(spec);
+        if (s.field < 0) {
+            s.field = static_cast<std::int32_t>(t.fields_.size());
+            t.fields_.emplace_back(spec);
+        }
+        t.segments_.push_back(s);
+        pos = close + 2;
+    }
+    return t;
+}
+
+int ReceiptTemplate::field_index(std::string_view name) const {
+    for (std::size_t i = 0; i < fields_.size(); ++i)
+        if (fields_[i] == name) return static_cast<int>(i);
+    return -1;
+}
+
+void ReceiptTemplate::render(std::span<const std::string_view> values, std::string& out) const {
+    std::size_t need = literals_.size();
+    for (const auto& s : segments_) {
+        if (s.field < 0) continue;
+        const auto n = static_cast<std::size_t>(s.field) < values.size() ? values[s.field].size() : 0;
+        need += std::max<std::size_t>(n, s.width);
+    }
+    out.reserve(out.size() + need);
+
+    for (const auto& s : segments_) {
+        if (s.field < 0) {
+            out.append(literals_, s.offset, s.length);
+            continue;
+        }
+        const std::string_view v = static_cast<std::size_t>(s.field) < values.size()
+            ? values[s.field] : std::string_view{};
+        const std::size_t pad = v.size() < s.width ? s.width - v.size() : 0;
+        if (s.right) out.append(pad, ' ');
+        out.append(v);
+        if (!s.right) out.append(pad, ' ');
+    }
+}
+
+void ReceiptTemplate::render_json(const nlohmann::json& values, std::string& out) const {
+    std::vector<std::string> text(fields_.size());
+    std::vector<std::string_view> views(fields_.size());
+    for (std::size_t i = 0; i < fields_.size(); ++i) {
+        auto it = values.find(fields_[i]);
+        if (it == values.end() || it->is_null()) continue;
+        text[i] = it->is_string() ? it->get<std::string>() : it->dump();
+        views[i] = text[i];
+    }
+    render(std::span<const std::string_view>(views), out);
+}
+
+} // namespace atmsp
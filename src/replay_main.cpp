@@ -0,0 +1,131 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "atmsp/logging.h"
+#include "atmsp/event_bus.h"
+#include "atmsp/events.h"
+#include "atmsp/journal.h"
+#include "atmsp/time_source.h"
+
+// Streams a binary event journal back through an EventBus.
+//   --speed 1   replays with the original inter-event gaps
+//   --speed N   replays N times faster
+//   --max       publishes as fast as possible (load reproduction)
+
+static void print_usage() {
+    std::cout
+      << "atmsp_replay usage:\n"
+      << "  atmsp_replay [--journal <dir>|--journal=<dir>] [--speed <N>|--speed=N] [--max] [--quiet] [--help]\n"
+      << "Options:\n"
+      << "  --journal    Journal directory (default: logs/journal)\n"
+      << "  --speed      Replay speed multiplier, e.g. 1, 10, 0.5 (default: 1)\n"
+      << "  --max        Ignore recorded timing and replay at maximum speed\n"
+      << "  --quiet      Do not log each event, only the summary\n"
+      << "  --help       Show this help and exit\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace atmsp;
+
+    std::string dir = "logs/journal";
+    double speed = 1.0;
+    bool maxSpeed = false;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h" || a == "/?") {
+            print_usage();
+            return 0;
+        }
+        else if (a == "--journal" && (i + 1) < argc) {
+            dir = argv[++i];
+        }
+        else if (a.rfind("--journal=", 0) == 0) {
+            dir = a.substr(std::string("--journal=").size());
+        }
+        else if (a == "--speed" && (i + 1) < argc) {
+            try { speed = std::stod(argv[++i]); } catch (...) { speed = 1.0; }
+        }
+        else if (a.rfind("--speed=", 0) == 0) {
+            try { speed = std::stod(a.substr(std::string("--speed=").size())); } catch (...) { speed = 1.0; }
+        }
+        else if (a == "--max") {
+            maxSpeed = true;
+        }
+        else if (a == "--quiet") {
+            quiet = true;
+        }
+        else {
+            std::cerr << "Unknown argument: " << a << "\n";
+            print_usage();
+            return 2;
+        }
+    }
+    if (speed <= 0.0) speed = 1.0;
+
+    spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+
+    EventBus bus;
+    std::int64_t curTs = 0;
+    std::size_t published = 0;
+    if (!quiet) {
+        bus.subscribe([&](const Event& e){
+            std::visit([&](auto&& ev){
+                using E = std::decay_t<decltype(ev)>;
+                const auto at = format_wall_ns(curTs, true);
+                if constexpr (std::is_same_v<E, ErrorEvent>) {
+                    spdlog::info("[{}] ErrorEvent code={} msg={}", at.view(), ev.code, ev.message);
+                } else if constexpr (std::is_same_v<E, SessionStarted>) {
+                    spdlog::info("[{}] SessionStarted id={}", at.view(), ev.sessionId);
+                } else if constexpr (std::is_same_v<E, SessionEnded>) {
+                    spdlog::info("[{}] SessionEnded id={} rc={}", at.view(), ev.sessionId, ev.resultCode);
+                } else if constexpr (std::is_same_v<E, CardInserted>) {
+                    spdlog::info("[{}] CardInserted", at.view());
+                } else if constexpr (std::is_same_v<E, Track2Read>) {
+                    spdlog::info("[{}] Track2Read PAN={}", at.view(), ev.pan);   // already masked on disk
+                } else if constexpr (std::is_same_v<E, CardRemoved>) {
+                    spdlog::info("[{}] CardRemoved", at.view());
+                } else if constexpr (std::is_same_v<E, PinRequested>) {
+                    spdlog::info("[{}] PinRequested min={} max={} bypass={}", at.view(), ev.minLen, ev.maxLen, ev.bypassAllowed);
+                } else if constexpr (std::is_same_v<E, PinEntered>) {
+                    spdlog::info("[{}] PinEntered masked={}", at.view(), ev.masked);
+                } else if constexpr (std::is_same_v<E, ChipReady>) {
+                    spdlog::info("[{}] ChipReady contactless={}", at.view(), ev.contactless);
+                } else if constexpr (std::is_same_v<E, SensorChanged>) {
+                    spdlog::info("[{}] SensorChanged {}={}", at.view(), to_string(ev.sensor), ev.value);
+                }
+            }, e);
+        });
+    }
+
+    JournalReader reader(dir);
+    if (reader.segment_count() == 0) {
+        spdlog::error("No journal segments found in '{}'", dir);
+        return 1;
+    }
+    spdlog::info("Replaying {} segment(s) from '{}' at {}", reader.segment_count(), dir,
+                 maxSpeed ? std::string("max speed") : std::to_string(speed) + "x");
+
+    Stopwatch sw;
+    const auto wallStart = std::chrono::steady_clock::now();
+    std::int64_t firstTs = -1;
+    while (auto rec = reader.next()) {
+        if (firstTs < 0) firstTs = rec->tsNs;
+        if (!maxSpeed) {
+            const auto offset = std::chrono::nanoseconds(
+                static_cast<std::int64_t>(static_cast<double>(rec->tsNs - firstTs) / speed));
+            std::this_thread::sleep_until(wallStart + offset);
+        }
+        curTs = rec->tsNs;
+        bus.publish(rec->event);
+        ++published;
+    }
+
+    const double elapsed = sw.elapsed_ms() / 1000.0;
+    spdlog::info("Replay finished: {} events in {:.3f}s ({:.0f} ev/s)", published, elapsed,
+                 elapsed > 0 ? static_cast<double>(published) / elapsed : 0.0);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "atmsp/session_arena.h"
+#include <algorithm>
+
+namespace atmsp {
+
+// ---- SessionArena -------------------------------------------------------------
+
+SessionArena::SessionArena(std::size_t initialBytes, ArenaPool* pool)
+    : pool_(pool),
+      initial_(std::make_unique<std::byte[]>(initialBytes)),
+      initial_size_(initialBytes),
+      mono_(initial_.get(), initial_size_, std::pmr::new_delete_resource()) {}
+
+void* SessionArena::do_allocate(std::size_t bytes, std::size_t align) {
+    std::lock_guard<std::mutex> lk(mu_);
+    void* p = mono_.allocate(bytes, align);
+    ++stats_.allocations;
+    stats_.bytes += bytes;
+    ++stats_.live;
+    return p;
+}
+
+void SessionArena::do_deallocate(void*, std::size_t, std::size_t) {
+    bool recycle = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (stats_.live > 0) --stats_.live;
+        recycle = retired_ && stats_.live == 0;
+    }
+    // Last straggler from a finished session (e.g. a late completion).
+    if (recycle) {
+        if (pool_) pool_->recycle(this);
+        else reset();
+    }
+}
+
+void SessionArena::retire() {
+    bool recycle = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        retired_ = true;
+        recycle = stats_.live == 0;
+    }
+    if (recycle) {
+        if (pool_) pool_->recycle(this);
+        else reset();
+    }
+}
+
+SessionArena::Stats SessionArena::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+void SessionArena::reset() {
+    std::lock_guard<std::mutex> lk(mu_);
+    mono_.release();     // back to the initial block; overflow blocks are freed
+    stats_ = {};
+    retired_ = false;
+}
+
+// ---- ArenaPool -----------------------------------------------------------------
+
+ArenaPool::ArenaPool(std::size_t arenaBytes, std::size_t maxIdle)
+    : arena_bytes_(std::max<std::size_t>(arenaBytes, 256)), max_idle_(maxIdle) {}
+
+ArenaPool::~ArenaPool() = default;
+
+ArenaPool& ArenaPool::shared() {
+    // Never destroyed: completions from the last sessions may be released
+    // during static destruction.
+    static ArenaPool* pool = new ArenaPool();
+    return *pool;
+}
+
+SessionArena* ArenaPool::acquire() {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!idle_.empty()) {
+        auto* a = idle_.back();
+        idle_.pop_back();
+        return a;
+    }
+    all_.push_back(std::make_unique<SessionArena>(arena_bytes_, this));
+    return all_.back().get();
+}
+
+void ArenaPool::recycle(SessionArena* a) {
+    a->reset();
+    std::lock_guard<std::mutex> lk(mu_);
+    if (idle_.size() < max_idle_) {
+        idle_.push_back(a);
+        return;
+    }
+    all_.erase(std::remove_if(all_.begin(), all_.end(),
+        [&](const std::unique_ptr<SessionArena>& p){ return p.get() == a; }), all_.end());
+}
+
+ArenaPoolStats ArenaPool::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    ArenaPoolStats s;
+    s.owned = all_.size();
+    s.idle = idle_.size();
+    s.draining = 0;
+    for (const auto& a : all_) {
+        if (std::find(idle_.begin(), idle_.end(), a.get()) != idle_.end()) continue;
+        std::lock_guard<std::mutex> alk(a->mu_);
+        if (a->retired_) ++s.draining;
+    }
+    return s;
+}
+
+} // namespace atmsp
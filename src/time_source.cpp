@@ -0,0 +1,185 @@
+#include "atmsp/time_source.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define ATMSP_HAVE_TSC 1
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#    include <x86intrin.h>
+#  endif
+#endif
+
+namespace atmsp {
+
+namespace {
+
+using SteadyNs = std::chrono::nanoseconds;
+
+std::int64_t steady_ns() noexcept {
+    return std::chrono::duration_cast<SteadyNs>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t system_ns() noexcept {
+    return std::chrono::duration_cast<SteadyNs>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#ifdef ATMSP_HAVE_TSC
+bool invariant_tsc() {
+    if (std::getenv("ATMSP_NO_TSC")) return false;   // escape hatch for odd hypervisors
+# ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 0x80000000);
+    if (static_cast<unsigned>(r[0]) < 0x80000007u) return false;
+    __cpuid(r, 0x80000007);
+    return (r[3] & (1 << 8)) != 0;
+# else
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000007, &a, &b, &c, &d)) return false;
+    return (d & (1u << 8)) != 0;
+# endif
+}
+#endif
+
+struct Calibration {
+    bool tsc{false};
+    std::uint64_t tsc0{0};
+    double nsPerTick{0.0};
+};
+
+// Measures the TSC rate against steady_clock once, on first use (~10 ms).
+const Calibration& calibration() {
+    static const Calibration c = []{
+        Calibration k;
+#ifdef ATMSP_HAVE_TSC
+        if (invariant_tsc()) {
+            const std::int64_t t0 = steady_ns();
+            const std::uint64_t c0 = __rdtsc();
+            std::int64_t t1 = t0;
+            while (t1 - t0 < 10'000'000) t1 = steady_ns();
+            const std::uint64_t c1 = __rdtsc();
+            if (c1 > c0) {
+                k.tsc = true;
+                k.tsc0 = c0;
+                k.nsPerTick = static_cast<double>(t1 - t0) / static_cast<double>(c1 - c0);
+            }
+        }
+#endif
+        return k;
+    }();
+    return c;
+}
+
+// Monotonic -> wall offset and the TimeSource time it was taken at.
+struct WallAnchor {
+    std::atomic<std::int64_t> offset;
+    std::atomic<std::int64_t> at;
+    WallAnchor() {
+        const std::int64_t t = TimeSource::now_ns();
+        offset.store(system_ns() - t);
+        at.store(t);
+    }
+};
+
+WallAnchor& wall_anchor() {
+    static WallAnchor a;
+    return a;
+}
+
+constexpr std::int64_t kReanchorNs = 1'000'000'000;
+
+// Driven by the stamps being converted, so the hot path reads no clock: only
+// a stamp more than kReanchorNs past the anchor pays for a system_clock read,
+// and the CAS lets a single thread do it.
+void maybe_reanchor(std::int64_t stampNs) noexcept {
+    auto& a = wall_anchor();
+    std::int64_t at = a.at.load(std::memory_order_relaxed);
+    if (stampNs - at < kReanchorNs) return;
+    if (!a.at.compare_exchange_strong(at, stampNs, std::memory_order_relaxed)) return;
+    TimeSource::resync();
+}
+
+} // namespace
+
+std::int64_t TimeSource::now_ns() noexcept {
+    const auto& c = calibration();
+#ifdef ATMSP_HAVE_TSC
+    if (c.tsc)
+        return static_cast<std::int64_t>(static_cast<double>(__rdtsc() - c.tsc0) * c.nsPerTick);
+#endif
+    (void)c;
+    return steady_ns();
+}
+
+void TimeSource::resync() noexcept {
+    auto& a = wall_anchor();
+    const std::int64_t t = now_ns();
+    a.offset.store(system_ns() - t, std::memory_order_relaxed);
+    a.at.store(t, std::memory_order_relaxed);
+}
+
+std::string_view TimeSource::backend() noexcept {
+    return calibration().tsc ? "tsc" : "steady";
+}
+
+std::int64_t Timestamp::wall_ns() const noexcept {
+    maybe_reanchor(ns);
+    return ns + wall_anchor().offset.load(std::memory_order_relaxed);
+}
+
+std::chrono::system_clock::time_point Timestamp::wall() const noexcept {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(SteadyNs(wall_ns())));
+}
+
+Timestamp Timestamp::from_wall_ns(std::int64_t wallNs) noexcept {
+    return Timestamp{ wallNs - wall_anchor().offset.load(std::memory_order_relaxed) };
+}
+
+TimeText format_wall_ns(std::int64_t wallNs, bool millis) {
+    // Floor division so pre-epoch values still land on the right second.
+    std::int64_t sec = wallNs / 1'000'000'000;
+    std::int64_t sub = wallNs % 1'000'000'000;
+    if (sub < 0) { --sec; sub += 1'000'000'000; }
+
+    thread_local std::int64_t cachedSec = std::numeric_limits<std::int64_t>::min();
+    thread_local char cached[24];
+    thread_local std::size_t cachedLen = 0;
+    if (sec != cachedSec) {
+        std::time_t tt = static_cast<std::time_t>(sec);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &tt);
+#else
+        localtime_r(&tt, &tm);
+#endif
+        cachedLen = std::strftime(cached, sizeof(cached), "%F %T", &tm);
+        cachedSec = sec;
+    }
+
+    TimeText t;
+    std::memcpy(t.data, cached, cachedLen);
+    t.len = cachedLen;
+    if (millis) {
+        const int ms = static_cast<int>(sub / 1'000'000);
+        t.data[t.len++] = '.';
+        t.data[t.len++] = static_cast<char>('0' + ms / 100);
+        t.data[t.len++] = static_cast<char>('0' + (ms / 10) % 10);
+        t.data[t.len++] = static_cast<char>('0' + ms % 10);
+    }
+    return t;
+}
+
+TimeText format_time(Timestamp ts, bool millis) {
+    return format_wall_ns(ts.wall_ns(), millis);
+}
+
+} // namespace atmsp
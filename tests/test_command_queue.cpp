@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "atmsp/command_queue.h"
+#include "atmsp/session_arena.h"
+#include "atmsp/time_source.h"
+
+using namespace atmsp;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records every execute() and completes it asynchronously after a short delay.
+class RecordingSP final : public IServiceProvider {
+public:
+    std::string name() const override { return "RecordingSP"; }
+    SpError init(EventBus*) override { return SpError::Ok; }
+    SpError open(const std::string&) override { return SpError::Ok; }
+    void close() override {}
+
+    std::future<nlohmann::json> execute(const std::string& command,
+                                        const nlohmann::json& payload) override {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            seen.push_back({command, payload});
+        }
+        const int now = ++outstanding;
+        int prev = peak.load();
+        while (now > prev && !peak.compare_exchange_weak(prev, now)) {}
+        return std::async(std::launch::async, [this, command, payload]{
+            std::this_thread::sleep_for(5ms);
+            --outstanding;
+            return nlohmann::json{{"ok", true}, {"command", command}, {"echo", payload}};
+        });
+    }
+
+    std::mutex mu;
+    std::vector<DeviceCommand> seen;
+    std::atomic<int> outstanding{0};
+    std::atomic<int> peak{0};
+};
+
+// "Slow" takes 300 ms, everything else 5 ms; records when each command arrived.
+class TimedSP final : public IServiceProvider {
+public:
+    std::string name() const override { return "TimedSP"; }
+    SpError init(EventBus*) override { return SpError::Ok; }
+    SpError open(const std::string&) override { return SpError::Ok; }
+    void close() override {}
+
+    std::future<nlohmann::json> execute(const std::string& command, const nlohmann::json&) override {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            arrivedMs[command] = sw.elapsed_ms();
+        }
+        const auto d = command == "Slow" ? 300ms : 5ms;
+        return std::async(std::launch::async, [command, d]{
+            std::this_thread::sleep_for(d);
+            return nlohmann::json{{"ok", true}, {"command", command}};
+        });
+    }
+
+    Stopwatch sw;
+    std::mutex mu;
+    std::map<std::string, double> arrivedMs;
+};
+
+} // namespace
+
+TEST(CommandQueue, DispatchesWhileSlowCommandIsInFlight) {
+    TimedSP sp;
+    CommandQueueOptions o;
+    o.maxInFlight = 4;
+    CommandQueue q(sp, o);
+
+    auto slow = q.submit("Slow");
+    std::this_thread::sleep_for(20ms);
+    auto fast = q.submit("Fast");
+
+    // Fast reaches the SP right away but still completes after Slow.
+    EXPECT_EQ(fast.wait_for(150ms), std::future_status::timeout);
+    {
+        std::lock_guard<std::mutex> lk(sp.mu);
+        ASSERT_EQ(sp.arrivedMs.count("Fast"), 1u);
+        EXPECT_LT(sp.arrivedMs["Fast"], 150.0);
+    }
+    EXPECT_EQ(slow.get()["command"], "Slow");
+    EXPECT_EQ(fast.get()["command"], "Fast");
+    EXPECT_EQ(q.stats().peakInFlight, 2u);
+}
+
+TEST(CommandQueue, BatchCompletesInOrderWithPipelining) {
+    RecordingSP sp;
+    CommandQueueOptions o;
+    o.maxInFlight = 3;
+    CommandQueue q(sp, o);
+
+    std::vector<DeviceCommand> batch;
+    for (int i = 0; i < 9; ++i) batch.push_back({"Step", {{"i", i}}});
+    auto futs = q.executeBatch(std::move(batch));
+    ASSERT_EQ(futs.size(), 9u);
+    for (int i = 0; i < 9; ++i)
+        EXPECT_EQ(futs[i].get()["echo"]["i"], i);
+
+    EXPECT_EQ(sp.seen.size(), 9u);
+    EXPECT_GT(sp.peak.load(), 1);
+    EXPECT_LE(sp.peak.load(), 3);
+}
+
+TEST(CommandQueue, CoalescesRepeatedSetters) {
+    RecordingSP sp;
+    CommandQueue q(sp);
+    auto futs = q.executeBatch({
+        {"SetFailureRate", {{"pct", 10}}},
+        {"SetFailureRate", {{"pct", 20}}},
+        {"RequestPin", {}},
+        {"SetFailureRate", {{"pct", 30}}},
+        {"SetFailureRate", {{"pct", 40}}},
+    });
+    ASSERT_EQ(futs.size(), 5u);
+    EXPECT_EQ(futs[0].get()["echo"]["pct"], 20);
+    EXPECT_EQ(futs[1].get()["echo"]["pct"], 20);
+    EXPECT_EQ(futs[2].get()["command"], "RequestPin");
+    EXPECT_EQ(futs[3].get()["echo"]["pct"], 40);
+    EXPECT_EQ(futs[4].get()["echo"]["pct"], 40);
+
+    q.drain();
+    // Setters never fold across RequestPin.
+    ASSERT_EQ(sp.seen.size(), 3u);
+    EXPECT_EQ(sp.seen[0].payload["pct"], 20);
+    EXPECT_EQ(sp.seen[1].command, "RequestPin");
+    EXPECT_EQ(sp.seen[2].payload["pct"], 40);
+    EXPECT_EQ(q.stats().coalesced, 2u);
+}
+
+TEST(CommandQueue, RejectsOverAdmissionLimits) {
+    RecordingSP sp;
+    CommandQueueOptions o;
+    o.admission = { .commandsPerSec = 1.0, .commandBurst = 2, .maxInFlight = 0 };
+    CommandQueue q(sp, o);
+    EXPECT_EQ(q.submit("A").get()["ok"], true);
+    EXPECT_EQ(q.submit("B").get()["ok"], true);
+    auto r = q.submit("C").get();
+    EXPECT_EQ(r["ok"], false);
+    EXPECT_EQ(r["error"], "RateLimited");
+    q.drain();
+    EXPECT_EQ(sp.seen.size(), 2u);
+    EXPECT_EQ(q.stats().rejected, 1u);
+}
+
+TEST(CommandQueue, BatchIsAdmittedWholeOrNotAtAll) {
+    RecordingSP sp;
+    CommandQueueOptions o;
+    o.admission = { .commandsPerSec = 1.0, .commandBurst = 3, .maxInFlight = 0 };
+    CommandQueue q(sp, o);
+    EXPECT_EQ(q.submit("Warmup").get()["ok"], true);   // two tokens left
+
+    // The third element would be over the limit: nothing in the batch runs.
+    auto futs = q.executeBatch({ {"A", {}}, {"B", {}}, {"C", {}} });
+    ASSERT_EQ(futs.size(), 3u);
+    for (auto& f : futs) EXPECT_EQ(f.get()["error"], "RateLimited");
+    q.drain();
+    EXPECT_EQ(sp.seen.size(), 1u);
+    EXPECT_EQ(q.stats().rejected, 3u);
+
+    // A batch that fits still goes through whole.
+    auto ok = q.executeBatch({ {"D", {}}, {"E", {}} });
+    for (auto& f : ok) EXPECT_EQ(f.get()["ok"], true);
+    q.drain();
+    EXPECT_EQ(sp.seen.size(), 3u);
+}
+
+TEST(CommandQueue, AllocatesPerCommandStateFromCallerResource) {
+    RecordingSP sp;
+    ArenaPool pool(4096);
+    CommandQueue q(sp);
+    SessionArena* arena = pool.acquire();
+
+    auto f = q.submit("A", {{"n", 1}}, arena);
+    // Completion shared state, the queue entry and its waiter list.
+    EXPECT_GE(arena->stats().allocations, 3u);
+    EXPECT_EQ(f.get()["ok"], true);
+    q.drain();
+    f = {};
+    EXPECT_EQ(arena->stats().live, 0u);
+
+    arena->retire();
+    EXPECT_EQ(pool.stats().idle, 1u);
+}
+
+TEST(CommandQueue, BatchLargerThanBurstRunsFromIdle) {
+    RecordingSP sp;
+    CommandQueueOptions o;
+    o.admission = { .commandsPerSec = 20.0, .commandBurst = 5, .maxInFlight = 4 };
+    CommandQueue q(sp, o);
+    std::vector<DeviceCommand> setup;
+    for (int i = 0; i < 6; ++i) setup.push_back({"Set" + std::to_string(i), {}});
+    auto futs = q.executeBatch(std::move(setup));
+    for (auto& f : futs) EXPECT_EQ(f.get()["ok"], true);
+    q.drain();
+    EXPECT_EQ(sp.seen.size(), 6u);
+    EXPECT_EQ(q.stats().rejected, 0u);
+}
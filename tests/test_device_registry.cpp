@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "atmsp/device_registry.h"
+#include "atmsp/time_source.h"
+
+using namespace atmsp;
+using namespace std::chrono_literals;
+
+namespace {
+
+class SlowOpenSP final : public IServiceProvider {
+public:
+    explicit SlowOpenSP(std::chrono::milliseconds d) : delay_(d) {}
+    std::string name() const override { return "SlowOpenSP"; }
+    SpError init(EventBus* bus) override { return bus ? SpError::Ok : SpError::NotInitialized; }
+    SpError open(const std::string&) override { std::this_thread::sleep_for(delay_); return SpError::Ok; }
+    void close() override {}
+    std::future<nlohmann::json> execute(const std::string&, const nlohmann::json&) override {
+        std::promise<nlohmann::json> p;
+        p.set_value(nlohmann::json{{"ok", true}});
+        return p.get_future();
+    }
+private:
+    std::chrono::milliseconds delay_;
+};
+
+DeviceConfig device(const char* type, int openMs) {
+    DeviceConfig dc;
+    dc.type = type;
+    dc.openMs = openMs;
+    return dc;
+}
+
+} // namespace
+
+TEST(DeviceRegistry, OpensDevicesInParallel) {
+    EventBus bus;
+    DeviceRegistry reg;
+    reg.register_type("slow", []{ return std::make_unique<SlowOpenSP>(150ms); });
+
+    AppConfig cfg;
+    cfg.devices["DEV1"] = device("slow", 2000);
+    cfg.devices["DEV2"] = device("slow", 2000);
+    cfg.devices["DEV3"] = device("slow", 2000);
+    cfg.devices["DEV4"] = device("slow", 2000);
+
+    auto r = reg.bring_up(cfg, bus);
+    EXPECT_EQ(r.opened(), 4u);
+    EXPECT_GE(r.slowestMs, 140.0);
+    EXPECT_LT(r.totalMs, 450.0);   // sequential would be ~600 ms
+    EXPECT_NE(reg.get("DEV3"), nullptr);
+    reg.close_all();
+}
+
+TEST(DeviceRegistry, ReportsTimeoutsAndUnknownTypes) {
+    EventBus bus;
+    DeviceRegistry reg;
+    reg.register_type("fast", []{ return std::make_unique<SlowOpenSP>(10ms); });
+    reg.register_type("hang", []{ return std::make_unique<SlowOpenSP>(600ms); });
+
+    AppConfig cfg;
+    cfg.devices["CARDREADER1"] = device("fast", 2000);
+    cfg.devices["STUCK1"]      = device("hang", 100);
+    cfg.devices["PRINTER9"]    = device("no_such_type", 1000);
+
+    Stopwatch sw;
+    auto r = reg.bring_up(cfg, bus);
+    EXPECT_LT(sw.elapsed_ms(), 500.0);
+    ASSERT_EQ(r.devices.size(), 3u);
+    for (const auto& d : r.devices) {
+        if (d.logical == "CARDREADER1") {
+            EXPECT_EQ(d.result, SpError::Ok);
+        }
+        if (d.logical == "STUCK1") {
+            EXPECT_EQ(d.result, SpError::Timeout);
+            EXPECT_TRUE(d.timedOut);
+        }
+        if (d.logical == "PRINTER9") {
+            EXPECT_EQ(d.result, SpError::Unsupported);
+        }
+    }
+    EXPECT_NE(reg.get("CARDREADER1"), nullptr);
+    EXPECT_EQ(reg.get("STUCK1"), nullptr);
+    reg.close_all();   // waits for the abandoned open() before bus goes away
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "atmsp/journal.h"
+
+using namespace atmsp;
+namespace fs = std::filesystem;
+
+static std::string fresh_dir(const char* name) {
+    auto d = fs::temp_directory_path() / name;
+    fs::remove_all(d);
+    return d.string();
+}
+
+TEST(Journal, RoundTripsEventsAndMasksPan) {
+    JournalOptions o;
+    o.dir = fresh_dir("atmsp_journal_roundtrip");
+    {
+        EventJournal j(o);
+        ASSERT_TRUE(j.start());
+        EventBus bus;
+        j.attach(bus);
+        bus.publish(SessionStarted{.sessionId = "S-1"});
+        bus.publish(CardInserted{});
+        Track2Read t2;
+        t2.pan = "5413330089012345";
+        t2.exp = "2512";
+        t2.raw = "5413330089012345=25121010000012345678?";
+        bus.publish(t2);
+        bus.publish(PinRequested{.minLen = 4, .maxLen = 6, .bypassAllowed = true});
+        bus.publish(SessionEnded{.sessionId = "S-1", .resultCode = 3});
+        j.detach();
+        j.stop();
+        EXPECT_EQ(j.stats().records, 5u);
+    }
+
+    JournalReader r(o.dir);
+    std::vector<JournalRecord> recs;
+    while (auto rec = r.next()) recs.push_back(std::move(*rec));
+    ASSERT_EQ(recs.size(), 5u);
+
+    EXPECT_EQ(std::get<SessionStarted>(recs[0].event).sessionId, "S-1");
+    EXPECT_TRUE(std::holds_alternative<CardInserted>(recs[1].event));
+    const auto& t2 = std::get<Track2Read>(recs[2].event);
+    EXPECT_TRUE(recs[2].panMasked);
+    EXPECT_EQ(t2.pan, "541333******2345");
+    EXPECT_EQ(t2.exp, "2512");
+    EXPECT_TRUE(t2.raw.empty());
+    const auto& pr = std::get<PinRequested>(recs[3].event);
+    EXPECT_EQ(pr.maxLen, 6);
+    EXPECT_TRUE(pr.bypassAllowed);
+    EXPECT_EQ(std::get<SessionEnded>(recs[4].event).resultCode, 3);
+    EXPECT_LE(recs[0].tsNs, recs[4].tsNs);
+}
+
+TEST(Journal, RotatesSegments) {
+    JournalOptions o;
+    o.dir = fresh_dir("atmsp_journal_rotate");
+    o.segmentBytes = 8 * 1024;
+    o.maxSegments = 0;
+    EventJournal j(o);
+    ASSERT_TRUE(j.start());
+    for (int i = 0; i < 2000; ++i) {
+        j.append(ErrorEvent{.code = i, .message = "rotation test"});
+        if (i % 50 == 49) j.flush();   // a commit always leaves a spare ready
+    }
+    j.stop();
+
+    EXPECT_EQ(j.stats().dropped, 0u);
+    EXPECT_GT(list_journal_segments(o.dir).size(), 1u);
+
+    JournalReader r(o.dir);
+    int expected = 0;
+    while (auto rec = r.next())
+        EXPECT_EQ(std::get<ErrorEvent>(rec->event).code, expected++);
+    EXPECT_EQ(expected, 2000);
+}
+
+TEST(Journal, DropsInsteadOfBlockingWhenNoSpareIsReady) {
+    JournalOptions o;
+    o.dir = fresh_dir("atmsp_journal_burst");
+    o.segmentBytes = 8 * 1024;
+    o.fsyncMs = 1000;           // committer will not catch up during the burst
+    o.maxSegments = 0;
+    EventJournal j(o);
+    ASSERT_TRUE(j.start());
+    for (int i = 0; i < 2000; ++i)
+        j.append(ErrorEvent{.code = i, .message = "burst test"});
+    j.stop();
+
+    const auto st = j.stats();
+    EXPECT_GT(st.dropped, 0u);
+    EXPECT_EQ(st.records + st.dropped, 2000u);
+
+    JournalReader r(o.dir);
+    std::uint64_t read = 0;
+    int last = -1;
+    while (auto rec = r.next()) {
+        const int code = std::get<ErrorEvent>(rec->event).code;
+        EXPECT_GT(code, last);
+        last = code;
+        ++read;
+    }
+    EXPECT_EQ(read, st.records);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string_view>
+#include <vector>
+#include "atmsp/event_bus.h"
+#include "atmsp/printer_sp.h"
+#include "atmsp/receipt_template.h"
+#include "atmsp/time_source.h"
+
+using namespace atmsp;
+
+namespace atmsp {
+std::unique_ptr<IPrinterSP> make_mock_printer(PrinterOptions opts);
+}
+
+TEST(ReceiptTemplate, CompilesFieldsAndRenders) {
+    auto t = ReceiptTemplate::compile("ATM {{id}}\nAMT {{amount:>8}}|\nREF {{id}} {{ref:<6}}|\n");
+    ASSERT_TRUE(t.has_value());
+    ASSERT_EQ(t->fields().size(), 3u);
+    EXPECT_EQ(t->field_index("id"), 0);
+    EXPECT_EQ(t->field_index("amount"), 1);
+    EXPECT_EQ(t->field_index("nope"), -1);
+
+    const std::vector<std::string_view> values = { "T01", "12.50", "AB" };
+    std::string out;
+    t->render(values, out);
+    EXPECT_EQ(out, "ATM T01\nAMT    12.50|\nREF T01 AB    |\n");
+
+    std::string fromJson;
+    t->render_json(nlohmann::json{{"id", "T01"}, {"amount", "12.50"}, {"ref", "AB"}}, fromJson);
+    EXPECT_EQ(fromJson, out);
+}
+
+TEST(ReceiptTemplate, RejectsMalformedText) {
+    std::string err;
+    EXPECT_FALSE(ReceiptTemplate::compile("AMT {{amount", &err).has_value());
+    EXPECT_FALSE(err.empty());
+    EXPECT_FALSE(ReceiptTemplate::compile("{{}}").has_value());
+    EXPECT_FALSE(ReceiptTemplate::compile("{{x:^4}}").has_value());
+    EXPECT_FALSE(ReceiptTemplate::compile("{{x:>abc}}").has_value());
+    EXPECT_TRUE(ReceiptTemplate::compile("no fields at all").has_value());
+}
+
+TEST(MockPrinter, PrintReturnsBeforeDeviceAndSpoolAppliesBackpressure) {
+    EventBus bus;
+    PrinterOptions o;
+    o.spoolCapacity = 4;
+    o.msPerLine = 0;
+    o.cutMs = 100;
+    auto p = make_mock_printer(o);
+    ASSERT_EQ(p->init(&bus), SpError::Ok);
+    ASSERT_EQ(p->open("PRINTER1"), SpError::Ok);
+    ASSERT_EQ(p->load_template("r", "TXN {{n}}\n"), SpError::Ok);
+    auto t = p->find_template("r");
+    ASSERT_NE(t, nullptr);
+
+    const std::vector<std::string_view> values = { "1" };
+    Stopwatch sw;
+    std::vector<PrintTicket> tickets;
+    for (int i = 0; i < 8; ++i) tickets.push_back(p->print(*t, values));
+    EXPECT_LT(sw.elapsed_ms(), 50.0);      // device needs 100 ms per receipt
+
+    int accepted = 0, busy = 0;
+    for (const auto& tk : tickets) {
+        if (tk.result == SpError::Ok) ++accepted;
+        if (tk.result == SpError::Busy) ++busy;
+    }
+    EXPECT_GE(accepted, 4);                // spool + the one being printed
+    EXPECT_LE(accepted, 5);
+    EXPECT_EQ(accepted + busy, 8);
+
+    ASSERT_TRUE(p->wait_idle(2000));
+    const auto s = p->stats();
+    EXPECT_EQ(s.printed, static_cast<std::uint64_t>(accepted));
+    EXPECT_EQ(s.rejected, static_cast<std::uint64_t>(busy));
+    EXPECT_EQ(s.queued, 0u);
+    p->close();
+    EXPECT_EQ(p->print(*t, values).result, SpError::NotOpen);
+}
+
+TEST(MockPrinter, JsonCommands) {
+    EventBus bus;
+    PrinterOptions o;
+    o.msPerLine = 0;
+    o.cutMs = 0;
+    auto p = make_mock_printer(o);
+    p->init(&bus);
+    p->open("PRINTER1");
+
+    EXPECT_EQ(p->execute("LoadTemplate", {{"name", "r"}, {"text", "AMT {{amount:>6}}\n"}}).get()["ok"], true);
+    auto bad = p->execute("LoadTemplate", {{"name", "x"}, {"text", "{{oops"}}).get();
+    EXPECT_EQ(bad["error"], "InvalidData");
+
+    auto r = p->execute("Print", {{"template", "r"}, {"fields", {{"amount", 20}}}}).get();
+    EXPECT_EQ(r["ok"], true);
+    EXPECT_EQ(r["jobId"], 1);
+    EXPECT_EQ(p->execute("Print", {{"template", "missing"}}).get()["error"], "UnknownTemplate");
+    EXPECT_EQ(p->execute("Nope", {}).get()["error"], "UnknownCommand");
+
+    ASSERT_TRUE(p->wait_idle(1000));
+    EXPECT_EQ(p->execute("GetStatus", {}).get()["printed"], 1);
+    p->close();
+}
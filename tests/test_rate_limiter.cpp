@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "atmsp/event_bus.h"
+#include "atmsp/rate_limiter.h"
+
+using namespace atmsp;
+
+TEST(RateLimiter, TokenBucketBurstThenRate) {
+    TokenBucket b(10.0, 3);              // 10/s, burst 3
+    const std::int64_t t0 = 1'000'000'000;
+    EXPECT_TRUE(b.try_acquire(t0));
+    EXPECT_TRUE(b.try_acquire(t0));
+    EXPECT_TRUE(b.try_acquire(t0));
+    EXPECT_FALSE(b.try_acquire(t0));
+    EXPECT_FALSE(b.try_acquire(t0 + 50'000'000));
+    EXPECT_TRUE(b.try_acquire(t0 + 100'000'000));   // one token per 100 ms
+    EXPECT_FALSE(b.try_acquire(t0 + 100'000'000));
+
+    TokenBucket unlimited;
+    for (int i = 0; i < 1000; ++i) EXPECT_TRUE(unlimited.try_acquire());
+}
+
+TEST(RateLimiter, AdmissionCapsInFlight) {
+    AdmissionController ac({ .commandsPerSec = 0, .commandBurst = 1, .maxInFlight = 2 });
+    EXPECT_EQ(ac.try_admit(), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(), SpError::TooManyInFlight);
+    ac.release();
+    EXPECT_EQ(ac.try_admit(), SpError::Ok);
+    EXPECT_EQ(ac.stats().overInFlight, 1u);
+    EXPECT_EQ(ac.inflight(), 2);
+}
+
+TEST(RateLimiter, EventBusShedsPerSource) {
+    EventBus bus;
+    int delivered = 0;
+    auto id = bus.subscribe([&](const Event&){ ++delivered; });
+    bus.set_rate_limit("CARDREADER1", 1.0, 5);
+    auto& chatty = bus.source("CARDREADER1");
+    auto& quiet  = bus.source("PINPAD1");
+    for (int i = 0; i < 100; ++i) bus.publish(chatty, CardInserted{});
+    EXPECT_TRUE(bus.publish(quiet, PinEntered{}));
+    EXPECT_EQ(delivered, 6);
+    EXPECT_EQ(chatty.published.load(), 5u);
+    EXPECT_EQ(chatty.shed.load(), 95u);
+    EXPECT_EQ(quiet.shed.load(), 0u);
+    bus.unsubscribe(id);
+}
+
+TEST(RateLimiter, TransactionEventsBypassSourceLimit) {
+    EventBus bus;
+    int inserted = 0, removed = 0, other = 0;
+    auto id = bus.subscribe([&](const Event& e){
+        if (std::holds_alternative<CardInserted>(e)) ++inserted;
+        else if (std::holds_alternative<CardRemoved>(e)) ++removed;
+        else ++other;
+    });
+    bus.set_rate_limit("CARDREADER1", 1.0, 1);
+    auto& src = bus.source("CARDREADER1");
+
+    // A chattering reader: each shed insert takes its removal with it.
+    for (int i = 0; i < 10; ++i) {
+        bus.publish(src, CardInserted{});
+        bus.publish(src, CardRemoved{});
+    }
+    EXPECT_EQ(inserted, 1);
+    EXPECT_EQ(removed, 1);
+    EXPECT_EQ(src.shed.load(), 18u);
+
+    // Over budget, but these are part of the transaction.
+    EXPECT_TRUE(bus.publish(src, Track2Read{}));
+    EXPECT_TRUE(bus.publish(src, PinEntered{}));
+    EXPECT_TRUE(bus.publish(src, ErrorEvent{}));
+    EXPECT_EQ(other, 3);
+    EXPECT_EQ(src.shed.load(), 18u);
+    bus.unsubscribe(id);
+}
+
+TEST(RateLimiter, SensorEdgesAreNeverShed) {
+    EventBus bus;
+    std::vector<SensorChanged> seen;
+    auto id = bus.subscribe([&](const Event& e){
+        if (auto* s = std::get_if<SensorChanged>(&e)) seen.push_back(*s);
+    });
+    bus.set_rate_limit("SENSORS1", 1.0, 2);
+    auto& src = bus.source("SENSORS1");
+    while (src.limit.try_acquire()) {}   // bucket empty
+
+    for (int i = 0; i < 20; ++i)
+        bus.publish(src, SensorChanged{ .sensor = SensorKind::Proximity, .value = i % 2 });
+    EXPECT_TRUE(bus.publish(src, SensorChanged{ .sensor = SensorKind::Tamper, .value = 1 }));
+    ASSERT_EQ(seen.size(), 21u);
+    EXPECT_EQ(seen.back().sensor, SensorKind::Tamper);
+    EXPECT_EQ(src.shed.load(), 0u);
+    bus.unsubscribe(id);
+}
+
+TEST(RateLimiter, BatchAdmissionIsAllOrNothing) {
+    AdmissionController ac({ .commandsPerSec = 1.0, .commandBurst = 3, .maxInFlight = 4 });
+    EXPECT_EQ(ac.try_admit(2), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(2), SpError::RateLimited);   // only one token left
+    EXPECT_EQ(ac.inflight(), 2);
+    EXPECT_EQ(ac.try_admit(1), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(2), SpError::TooManyInFlight);
+    EXPECT_EQ(ac.inflight(), 3);
+}
+
+TEST(RateLimiter, OversizedBatchIsAdmittedWhenIdle) {
+    // Larger than both the burst and the in-flight cap.
+    TokenBucket b(1.0, 2);
+    const std::int64_t t0 = 1'000'000'000'000;
+    EXPECT_TRUE(b.try_acquire_n(3, t0));
+    EXPECT_FALSE(b.try_acquire(t0));                  // paying back the overdraft
+    EXPECT_FALSE(b.try_acquire_n(3, t0 + 2'000'000'000));
+    EXPECT_TRUE(b.try_acquire_n(3, t0 + 3'000'000'000));
+
+    AdmissionController ac({ .commandsPerSec = 0, .commandBurst = 1, .maxInFlight = 2 });
+    EXPECT_EQ(ac.try_admit(3), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(1), SpError::TooManyInFlight);
+    ac.release(3);
+    EXPECT_EQ(ac.try_admit(1), SpError::Ok);
+    EXPECT_EQ(ac.try_admit(3), SpError::TooManyInFlight);   // not idle
+    ac.release(1);
+    EXPECT_EQ(ac.try_admit(3), SpError::Ok);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "atmsp/event_bus.h"
+#include "atmsp/sensors_sp.h"
+
+using namespace atmsp;
+using namespace std::chrono_literals;
+
+namespace atmsp {
+std::unique_ptr<ISensorsSP> make_mock_sensors(std::unique_ptr<ISensorBackend> backend, SensorOptions opts);
+}
+
+namespace {
+
+constexpr std::int64_t kMs = 1'000'000;
+
+struct Change { SensorKind sensor; int value; };
+
+SensorSnapshot snap(bool door, bool prox, int temp) {
+    SensorSnapshot s;
+    s.digital[0] = door;
+    s.digital[2] = prox;
+    s.analog[0] = static_cast<std::int16_t>(temp);
+    return s;
+}
+
+// Door follows the flag set by the test; nothing else moves.
+class ScriptedBackend final : public ISensorBackend {
+public:
+    void read(SensorSnapshot& out, std::int64_t) override {
+        std::lock_guard<std::mutex> lk(mu);
+        out = snap(door, false, 210);
+    }
+    std::mutex mu;
+    bool door{false};
+};
+
+} // namespace
+
+TEST(SensorFilter, QuietScansEmitNothing) {
+    SensorFilter f;
+    f.reset(snap(false, false, 210));
+    std::vector<Change> out;
+    for (int i = 0; i < 100; ++i)
+        EXPECT_FALSE(f.update(snap(false, false, 210), i * kMs, [&](SensorKind k, int v){ out.push_back({k, v}); }));
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(f.raw_transitions(), 0u);
+}
+
+TEST(SensorFilter, DebouncesContactBounce) {
+    SensorFilter f;   // door debounce 20 ms
+    f.reset(snap(false, false, 210));
+    std::vector<Change> out;
+    auto emit = [&](SensorKind k, int v){ out.push_back({k, v}); };
+
+    // 5 ms of bounce, then the door settles open.
+    const bool bounce[] = { true, false, true, true, false };
+    std::int64_t t = 0;
+    for (bool b : bounce) f.update(snap(b, false, 210), t += kMs, emit);
+    EXPECT_TRUE(out.empty());
+    for (int i = 0; i < 30; ++i) f.update(snap(true, false, 210), t += kMs, emit);
+
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].sensor, SensorKind::Door);
+    EXPECT_EQ(out[0].value, 1);
+    EXPECT_EQ(f.stable().value(0), 1);
+    EXPECT_GE(f.raw_transitions(), 4u);
+}
+
+TEST(SensorFilter, AnalogHysteresisAndDebounce) {
+    SensorOptions o;
+    o.debounceMs[3] = 10;
+    SensorFilter f(o);
+    f.reset(snap(false, false, 210));
+    std::vector<Change> out;
+    auto emit = [&](SensorKind k, int v){ out.push_back({k, v}); };
+
+    std::int64_t t = 0;
+    for (int i = 0; i < 50; ++i) f.update(snap(false, false, 210 + (i % 5) - 2), t += kMs, emit);
+    EXPECT_TRUE(out.empty());                    // noise inside hysteresis
+    f.update(snap(false, false, 230), t += kMs, emit);
+    f.update(snap(false, false, 210), t += kMs, emit);
+    EXPECT_TRUE(out.empty());                    // single-scan spike
+    for (int i = 0; i < 20; ++i) f.update(snap(false, false, 240), t += kMs, emit);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].sensor, SensorKind::Temperature);
+    EXPECT_EQ(out[0].value, 240);
+}
+
+TEST(MockSensors, PublishesOnlyDebouncedChanges) {
+    EventBus bus;
+    std::mutex mu;
+    std::vector<SensorChanged> seen;
+    auto id = bus.subscribe([&](const Event& e){
+        if (auto* s = std::get_if<SensorChanged>(&e)) {
+            std::lock_guard<std::mutex> lk(mu);
+            seen.push_back(*s);
+        }
+    });
+
+    auto backend = std::make_unique<ScriptedBackend>();
+    auto* script = backend.get();
+    SensorOptions o;
+    o.minPollUs = 500;
+    o.maxPollUs = 4000;
+    auto sp = make_mock_sensors(std::move(backend), o);
+    ASSERT_EQ(sp->init(&bus), SpError::Ok);
+    ASSERT_EQ(sp->open("SENSORS1"), SpError::Ok);
+
+    std::this_thread::sleep_for(60ms);
+    EXPECT_EQ(sp->stats().pollUs, 4000);         // backed off while quiet
+    { std::lock_guard<std::mutex> lk(script->mu); script->door = true; }
+    std::this_thread::sleep_for(100ms);
+
+    auto status = sp->execute("GetStatus", {}).get();
+    EXPECT_EQ(status["Door"], 1);
+    EXPECT_EQ(sp->execute("Nope", {}).get()["error"], "UnknownCommand");
+    sp->close();
+
+    const auto st = sp->stats();
+    EXPECT_GT(st.scans, 10u);
+    EXPECT_EQ(st.published, 1u);
+    std::lock_guard<std::mutex> lk(mu);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].sensor, SensorKind::Door);
+    EXPECT_EQ(seen[0].value, 1);
+    bus.unsubscribe(id);
+}
@@ -19,3 +19,34 @@ TEST(Session, Lifecycle) {
     EXPECT_EQ(ended, 1);
     bus.unsubscribe(id);
 }
+
+
+TEST(Session, ArenaRecycledAfterLastRelease) {
+    EventBus bus;
+    ArenaPool pool(4096);
+    std::future<int> fut;
+    {
+        Session s("TX1", bus, &pool);
+        EXPECT_EQ(s.arena(), nullptr);
+        s.start();
+        ASSERT_NE(s.arena(), nullptr);
+        auto p = s.make_promise<int>();
+        fut = p.get_future();
+        p.set_value(7);
+        EXPECT_GT(s.arena()->stats().live, 0u);
+        s.end();
+        EXPECT_EQ(s.arena(), nullptr);
+        EXPECT_EQ(s.resource(), std::pmr::get_default_resource());
+    }
+    // The completion still references the arena, so it is not reused yet.
+    EXPECT_EQ(pool.stats().draining, 1u);
+    EXPECT_EQ(fut.get(), 7);
+    fut = {};
+    EXPECT_EQ(pool.stats().idle, 1u);
+
+    Session s2("TX2", bus, &pool);
+    s2.start();
+    EXPECT_EQ(pool.stats().owned, 1u);   // reused, not reallocated
+    EXPECT_EQ(s2.arena()->stats().allocations, 0u);
+    s2.end();
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "atmsp/events.h"
+#include "atmsp/time_source.h"
+
+using namespace atmsp;
+using namespace std::chrono_literals;
+
+TEST(TimeSource, MonotonicAndTracksWallClock) {
+    auto a = TimeSource::now();
+    std::this_thread::sleep_for(20ms);
+    auto b = TimeSource::now();
+    EXPECT_GE(b - a, 15'000'000);
+    EXPECT_LT(b - a, 2'000'000'000);
+
+    const auto sys = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_LT(std::llabs(TimeSource::now().wall_ns() - sys), 50'000'000);
+
+    const auto back = Timestamp::from_wall_ns(b.wall_ns());
+    EXPECT_EQ(back.ns, b.ns);
+}
+
+TEST(TimeSource, ReanchorsWallClockForLaterStamps) {
+    // A stamp well past the current anchor triggers a fresh system_clock read.
+    const auto later = Timestamp{ TimeSource::now_ns() + 2'000'000'000 };
+    const auto sys = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_LT(std::llabs(later.wall_ns() - (sys + 2'000'000'000)), 50'000'000);
+
+    // Conversions stay consistent after the re-anchor.
+    const auto now = TimeSource::now();
+    EXPECT_EQ(Timestamp::from_wall_ns(now.wall_ns()).ns, now.ns);
+}
+
+TEST(TimeSource, FormatterMatchesStrftime) {
+    CardInserted e;
+    auto tt = std::chrono::system_clock::to_time_t(e.ts.wall());
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &tt);
+#else
+    localtime_r(&tt, &tm);
+#endif
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%F %T", &tm);
+    EXPECT_EQ(format_time(e.ts).str(), buf);
+    EXPECT_EQ(format_time(e.ts).view(), format_time(e.ts).view());
+
+    auto withMs = format_wall_ns(1'000'000'000LL * 1'700'000'000 + 42'000'000, true);
+    EXPECT_EQ(withMs.len, 23u);
+    EXPECT_EQ(withMs.view().substr(19), ".042");
+}